@@ -0,0 +1,85 @@
+#include "AllocationCounter.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+#if defined(__linux__) && defined(__GLIBC__)
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+// initial-exec so reading them never allocates, which would recurse into malloc.
+static __thread int isCounting __attribute__((tls_model("initial-exec")));
+static __thread long allocationCount __attribute__((tls_model("initial-exec")));
+
+int allocation_counter_is_supported(void) {
+    return 1;
+}
+
+void allocation_counter_start(void) {
+    allocationCount = 0;
+    isCounting = 1;
+}
+
+long allocation_counter_stop(void) {
+    isCounting = 0;
+    return allocationCount;
+}
+
+static inline void count_allocation(void) {
+    if (isCounting) {
+        allocationCount++;
+    }
+}
+
+void *malloc(size_t size) {
+    count_allocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    count_allocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    count_allocation();
+    return __libc_realloc(pointer, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+    count_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    count_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **result, size_t alignment, size_t size) {
+    count_allocation();
+    void *pointer = __libc_memalign(alignment, size);
+    if (pointer == NULL) {
+        return ENOMEM;
+    }
+    *result = pointer;
+    return 0;
+}
+
+#else
+
+int allocation_counter_is_supported(void) {
+    return 0;
+}
+
+void allocation_counter_start(void) {
+}
+
+long allocation_counter_stop(void) {
+    return 0;
+}
+
+#endif
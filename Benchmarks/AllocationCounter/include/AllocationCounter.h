@@ -0,0 +1,11 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+/// Counts heap allocations made by the calling thread between start and stop, by
+/// interposing malloc and friends. Only supported on glibc; elsewhere the count stays 0.
+int allocation_counter_is_supported(void);
+void allocation_counter_start(void);
+/// Stops counting and returns the allocations since the matching start.
+long allocation_counter_stop(void);
+
+#endif
@@ -0,0 +1,137 @@
+import Foundation
+
+/// One stage's timings over all samples, in nanoseconds per iteration of its body.
+struct BenchmarkResult: Codable {
+    let name: String
+    let samples: Int
+    let medianNanoseconds: UInt64
+    let minimumNanoseconds: UInt64
+    let p90Nanoseconds: UInt64
+}
+
+struct BenchmarkReport: Codable {
+    var version = 1
+    var platform: String
+    var results: [BenchmarkResult]
+}
+
+struct Benchmark {
+    let name: String
+    /// Builds the synthetic input once and returns the body to time.
+    let setUp: () -> () -> Void
+}
+
+final class BenchmarkRunner {
+
+    struct Options {
+        var filter: String?
+        var samples = 15
+        var warmup = 3
+        var outputPath: String?
+        var baselinePath: String?
+        /// Allowed slowdown of a stage's median against the baseline, as a fraction.
+        var threshold = 0.15
+        /// Don't fail stages the baseline has no result for.
+        var allowMissing = false
+    }
+
+    let options: Options
+
+    init(options: Options) {
+        self.options = options
+    }
+
+    // MARK: - Running
+
+    func run(_ benchmarks: [Benchmark]) -> BenchmarkReport {
+        var results: [BenchmarkResult] = []
+        for benchmark in benchmarks {
+            if let filter = options.filter, !benchmark.name.contains(filter) { continue }
+            let body = benchmark.setUp()
+            for _ in 0..<options.warmup {
+                body()
+            }
+            var durations: [UInt64] = []
+            durations.reserveCapacity(options.samples)
+            for _ in 0..<options.samples {
+                let start = DispatchTime.now().uptimeNanoseconds
+                body()
+                durations.append(DispatchTime.now().uptimeNanoseconds - start)
+            }
+            durations.sort()
+            let result = BenchmarkResult(name: benchmark.name,
+                                         samples: durations.count,
+                                         medianNanoseconds: durations[durations.count / 2],
+                                         minimumNanoseconds: durations[0],
+                                         p90Nanoseconds: durations[min(durations.count - 1, durations.count * 9 / 10)])
+            FileHandle.standardError.write("\(result.name): median \(Self.format(result.medianNanoseconds))\n".data(using: .utf8)!)
+            results.append(result)
+        }
+        return BenchmarkReport(platform: Self.platform, results: results)
+    }
+
+    // MARK: - Comparison
+
+    /// Prints each stage's change against `baseline` and returns the stages that fail:
+    /// those whose median slowed down by more than the threshold, and those missing from
+    /// the baseline unless `allowMissing` is set.
+    func regressions(of report: BenchmarkReport, against baseline: BenchmarkReport) -> [String] {
+        var baselineMedians: [String: UInt64] = [:]
+        for result in baseline.results {
+            baselineMedians[result.name] = result.medianNanoseconds
+        }
+        var regressed: [String] = []
+        for result in report.results {
+            guard let reference = baselineMedians[result.name], reference > 0 else {
+                print("  \(result.name): no baseline" + (options.allowMissing ? "" : "  MISSING"))
+                if !options.allowMissing {
+                    regressed.append(result.name)
+                }
+                continue
+            }
+            let change = Double(result.medianNanoseconds) / Double(reference) - 1
+            let failed = change > options.threshold
+            let percent = String(format: "%+.1f%%", change * 100)
+            print("  \(result.name): \(Self.format(reference)) -> \(Self.format(result.medianNanoseconds)) (\(percent))"
+                  + (failed ? "  REGRESSED" : ""))
+            if failed {
+                regressed.append(result.name)
+            }
+        }
+        return regressed
+    }
+
+    // MARK: - JSON
+
+    static func encode(_ report: BenchmarkReport) -> Data {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+        encoder.keyEncodingStrategy = .convertToSnakeCase
+        return try! encoder.encode(report)
+    }
+
+    static func decode(contentsOf path: String) throws -> BenchmarkReport {
+        let decoder = JSONDecoder()
+        decoder.keyDecodingStrategy = .convertFromSnakeCase
+        return try decoder.decode(BenchmarkReport.self, from: Data(contentsOf: URL(fileURLWithPath: path)))
+    }
+
+    private static func format(_ nanoseconds: UInt64) -> String {
+        return String(format: "%.1f µs", Double(nanoseconds) / 1_000)
+    }
+
+    private static var platform: String {
+        #if os(Linux)
+        let system = "linux"
+        #else
+        let system = "darwin"
+        #endif
+        #if arch(x86_64)
+        return system + "-x86_64"
+        #elseif arch(arm64)
+        return system + "-arm64"
+        #else
+        return system
+        #endif
+    }
+}
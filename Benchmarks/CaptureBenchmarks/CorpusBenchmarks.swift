@@ -0,0 +1,30 @@
+import Foundation
+import ScreenCorpus
+import ShareScreenGrypp
+
+/// The background stage of `ScreenCapturer` in its default single-pass mode (dirty check
+/// and, for changed frames, NV12 conversion) over one second of each corpus scenario,
+/// rendered at the output size of an iPhone 15 Pro Max capture. Frames are rendered
+/// during set-up, so only the pipeline is timed.
+enum CorpusBenchmarks {
+
+    static let frameCount = ScreenCorpusGenerator.framesPerSecond
+
+    static var all: [Benchmark] {
+        return CorpusScenario.allCases.map { scenario in
+            Benchmark(name: "corpus.\(scenario.rawValue).pipeline", setUp: { pipeline(scenario) })
+        }
+    }
+
+    private static func pipeline(_ scenario: CorpusScenario) -> () -> Void {
+        let resolution = CorpusResolution.iPhone15ProMax
+        let output = PipelineBenchmarks.outputSize(viewWidth: resolution.width, viewHeight: resolution.height)
+        let generator = ScreenCorpusGenerator(scenario: scenario, width: output.width, height: output.height)
+        // The transition's second covers its push.
+        let firstFrame = scenario == .transition ? 24 : 0
+        return PipelineBenchmarks.corpusPipeline(viewWidth: resolution.width, viewHeight: resolution.height,
+                                                 frameCount: frameCount) { index, base, bytesPerRow in
+            generator.render(frame: firstFrame + index, into: base, bytesPerRow: bytesPerRow)
+        }
+    }
+}
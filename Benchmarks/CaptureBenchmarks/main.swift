@@ -0,0 +1,84 @@
+import Foundation
+
+// Headless benchmarks of the capture pipeline stages:
+//
+//   swift run -c release CaptureBenchmarks \
+//       [--filter <name>] [--samples N] [--output results.json] \
+//       [--compare baseline.json] [--threshold 0.15] [--allow-missing]
+//
+// Results go to stdout as JSON unless --output is given. With --compare, each stage's
+// median is checked against the baseline and the exit status is 1 if any slowed down by
+// more than the threshold, or has no baseline result unless --allow-missing is given.
+//
+// No baseline is checked in; timings only compare on the machine that recorded them.
+// Record one there before comparing, and again whenever stages are added:
+//
+//   swift run -c release CaptureBenchmarks --output baseline.json
+
+func parseOptions(_ arguments: [String]) -> BenchmarkRunner.Options {
+    var options = BenchmarkRunner.Options()
+    var iterator = arguments.dropFirst().makeIterator()
+    func value(for flag: String) -> String {
+        guard let value = iterator.next() else {
+            FileHandle.standardError.write("missing value for \(flag)\n".data(using: .utf8)!)
+            exit(2)
+        }
+        return value
+    }
+    while let argument = iterator.next() {
+        switch argument {
+        case "--filter":
+            options.filter = value(for: argument)
+        case "--samples":
+            options.samples = max(1, Int(value(for: argument)) ?? options.samples)
+        case "--warmup":
+            options.warmup = max(0, Int(value(for: argument)) ?? options.warmup)
+        case "--output":
+            options.outputPath = value(for: argument)
+        case "--compare":
+            options.baselinePath = value(for: argument)
+        case "--threshold":
+            options.threshold = Double(value(for: argument)) ?? options.threshold
+        case "--allow-missing":
+            options.allowMissing = true
+        default:
+            FileHandle.standardError.write("unknown argument \(argument)\n".data(using: .utf8)!)
+            exit(2)
+        }
+    }
+    return options
+}
+
+let options = parseOptions(CommandLine.arguments)
+let runner = BenchmarkRunner(options: options)
+let pipeline = PipelineBenchmarks.all.map { Benchmark(name: $0.name, setUp: $0.setUp) }
+let report = runner.run(pipeline + CorpusBenchmarks.all)
+let json = BenchmarkRunner.encode(report)
+
+if let outputPath = options.outputPath {
+    do {
+        try json.write(to: URL(fileURLWithPath: outputPath))
+    } catch {
+        FileHandle.standardError.write("❌ Failed to write \(outputPath): \(error)\n".data(using: .utf8)!)
+        exit(2)
+    }
+} else if options.baselinePath == nil {
+    FileHandle.standardOutput.write(json)
+    FileHandle.standardOutput.write("\n".data(using: .utf8)!)
+}
+
+if let baselinePath = options.baselinePath {
+    let baseline: BenchmarkReport
+    do {
+        baseline = try BenchmarkRunner.decode(contentsOf: baselinePath)
+    } catch {
+        FileHandle.standardError.write("❌ Failed to read baseline \(baselinePath): \(error)\n".data(using: .utf8)!)
+        exit(2)
+    }
+    print("Compared with \(baselinePath) (threshold \(Int(options.threshold * 100))%):")
+    let regressed = runner.regressions(of: report, against: baseline)
+    if !regressed.isEmpty {
+        print("❌ \(regressed.count) stage(s) regressed or missing: \(regressed.joined(separator: ", "))")
+        exit(1)
+    }
+}
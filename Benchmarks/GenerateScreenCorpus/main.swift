@@ -0,0 +1,78 @@
+import Foundation
+import ScreenCorpus
+
+// Writes the synthetic screen corpus:
+//
+//   swift run -c release GenerateScreenCorpus --output-dir corpus \
+//       [--scenario form|list|spinner|transition|video|all] \
+//       [--device iphone-se|iphone-15|iphone-15-pro-max|ipad-pro-11|ipad-pro-13|all] \
+//       [--frames 60] [--format y4m|bgra] [--seed 1]
+//
+// One file per scenario and device, named <scenario>-<device>.<format>. The same seed
+// always produces byte-identical files.
+
+func fail(_ message: String) -> Never {
+    FileHandle.standardError.write("\(message)\n".data(using: .utf8)!)
+    exit(2)
+}
+
+var scenarios = CorpusScenario.allCases
+var resolutions = CorpusResolution.all
+var frameCount = 60
+var format = CorpusWriter.Format.y4m
+var seed: UInt64 = 1
+var outputDirectory: String?
+
+var arguments = CommandLine.arguments.dropFirst().makeIterator()
+while let argument = arguments.next() {
+    guard let value = arguments.next() else { fail("missing value for \(argument)") }
+    switch argument {
+    case "--scenario":
+        if value != "all" {
+            guard let scenario = CorpusScenario(rawValue: value) else { fail("unknown scenario \(value)") }
+            scenarios = [scenario]
+        }
+    case "--device":
+        if value != "all" {
+            guard let resolution = CorpusResolution.all.first(where: { $0.name == value }) else { fail("unknown device \(value)") }
+            resolutions = [resolution]
+        }
+    case "--frames":
+        guard let count = Int(value), count > 0 else { fail("--frames must be a positive integer") }
+        frameCount = count
+    case "--format":
+        guard let parsed = CorpusWriter.Format(rawValue: value) else { fail("unknown format \(value)") }
+        format = parsed
+    case "--seed":
+        guard let parsed = UInt64(value) else { fail("--seed must be an unsigned integer") }
+        seed = parsed
+    case "--output-dir":
+        outputDirectory = value
+    default:
+        fail("unknown argument \(argument)")
+    }
+}
+
+guard let outputDirectory = outputDirectory else { fail("--output-dir is required") }
+do {
+    try FileManager.default.createDirectory(atPath: outputDirectory, withIntermediateDirectories: true)
+} catch {
+    fail("❌ Failed to create \(outputDirectory): \(error)")
+}
+
+for scenario in scenarios {
+    for resolution in resolutions {
+        let path = "\(outputDirectory)/\(scenario.rawValue)-\(resolution.name).\(format.rawValue)"
+        let generator = ScreenCorpusGenerator(scenario: scenario, resolution: resolution, seed: seed)
+        do {
+            let writer = try CorpusWriter(path: path, format: format, width: resolution.width, height: resolution.height)
+            for index in 0..<frameCount {
+                writer.write(generator.render(frame: index))
+            }
+            writer.close()
+            print("✅ \(path)")
+        } catch {
+            fail("❌ Failed to write \(path): \(error)")
+        }
+    }
+}
@@ -0,0 +1,82 @@
+import Foundation
+
+/// Streams corpus frames to disk as raw BGRA (frames back to back, no header) or as a
+/// YUV4MPEG2 file with 4:2:0 BT.601 video-range planes, which ffmpeg and most encoders
+/// read directly.
+public final class CorpusWriter {
+
+    public enum Format: String {
+        case bgra
+        case y4m
+    }
+
+    public let format: Format
+    public let width: Int
+    public let height: Int
+    private let handle: FileHandle
+
+    public init(path: String, format: Format, width: Int, height: Int, framesPerSecond: Int = ScreenCorpusGenerator.framesPerSecond) throws {
+        precondition(width % 2 == 0 && height % 2 == 0, "4:2:0 needs even dimensions")
+        guard FileManager.default.createFile(atPath: path, contents: nil) else {
+            throw CocoaError(.fileWriteUnknown, userInfo: [NSFilePathErrorKey: path])
+        }
+        handle = try FileHandle(forWritingTo: URL(fileURLWithPath: path))
+        self.format = format
+        self.width = width
+        self.height = height
+        if format == .y4m {
+            handle.write(Data("YUV4MPEG2 W\(width) H\(height) F\(framesPerSecond):1 Ip A1:1 C420mpeg2 XCOLORRANGE=LIMITED\n".utf8))
+        }
+    }
+
+    /// Appends one tightly packed BGRA frame.
+    public func write(_ pixels: [UInt8]) {
+        precondition(pixels.count == width * height * 4, "frame size doesn't match the writer")
+        switch format {
+        case .bgra:
+            handle.write(Data(pixels))
+        case .y4m:
+            handle.write(Data("FRAME\n".utf8))
+            handle.write(Data(CorpusWriter.i420(fromBGRA: pixels, width: width, height: height)))
+        }
+    }
+
+    public func close() {
+        handle.closeFile()
+    }
+
+    // MARK: - Conversion
+
+    /// Planar Y, U, V with 2x2-averaged chroma, BT.601 video range.
+    public static func i420(fromBGRA pixels: [UInt8], width: Int, height: Int) -> [UInt8] {
+        let chromaWidth = width / 2
+        let chromaHeight = height / 2
+        var planes = [UInt8](repeating: 0, count: width * height + 2 * chromaWidth * chromaHeight)
+        let uOffset = width * height
+        let vOffset = uOffset + chromaWidth * chromaHeight
+        for y in 0..<height {
+            for x in 0..<width {
+                let i = (y * width + x) * 4
+                let b = Int(pixels[i]), g = Int(pixels[i + 1]), r = Int(pixels[i + 2])
+                planes[y * width + x] = UInt8(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16)
+            }
+        }
+        for cy in 0..<chromaHeight {
+            for cx in 0..<chromaWidth {
+                var r = 0, g = 0, b = 0
+                for (dx, dy) in [(0, 0), (1, 0), (0, 1), (1, 1)] {
+                    let i = ((cy * 2 + dy) * width + cx * 2 + dx) * 4
+                    b += Int(pixels[i])
+                    g += Int(pixels[i + 1])
+                    r += Int(pixels[i + 2])
+                }
+                r = (r + 2) / 4
+                g = (g + 2) / 4
+                b = (b + 2) / 4
+                planes[uOffset + cy * chromaWidth + cx] = UInt8(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128)
+                planes[vOffset + cy * chromaWidth + cx] = UInt8(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128)
+            }
+        }
+        return planes
+    }
+}
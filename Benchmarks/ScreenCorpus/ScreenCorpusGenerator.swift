@@ -0,0 +1,308 @@
+import Foundation
+
+/// Device screen sizes, in pixels, the corpus is rendered at. Every size is even.
+public struct CorpusResolution: Equatable {
+    public let name: String
+    public let width: Int
+    public let height: Int
+
+    public static let iPhoneSE = CorpusResolution(name: "iphone-se", width: 750, height: 1334)
+    /// 1179 pixels wide on the device; rounded up to even, since 4:2:0 frames need even
+    /// dimensions.
+    public static let iPhone15 = CorpusResolution(name: "iphone-15", width: 1180, height: 2556)
+    public static let iPhone15ProMax = CorpusResolution(name: "iphone-15-pro-max", width: 1290, height: 2796)
+    public static let iPadPro11 = CorpusResolution(name: "ipad-pro-11", width: 1668, height: 2388)
+    public static let iPadPro13 = CorpusResolution(name: "ipad-pro-13", width: 2048, height: 2732)
+
+    public static let all = [iPhoneSE, iPhone15, iPhone15ProMax, iPadPro11, iPadPro13]
+}
+
+/// Kinds of screen activity the capture pipeline has to handle.
+public enum CorpusScenario: String, CaseIterable {
+    /// A static form whose focused field has a caret blinking every 0.5 s.
+    case form
+    /// A list scrolling at a constant speed under a fixed navigation bar.
+    case list
+    /// A static screen with a small activity indicator rotating in the middle.
+    case spinner
+    /// Navigation pushes between two pages: 1 s still, 0.6 s slide, 0.4 s still.
+    case transition
+    /// A static page with a 16:9 video playing in it.
+    case video
+}
+
+/// Deterministic pseudo-random numbers, so every run of the corpus is byte-identical.
+struct SplitMix64 {
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E37_79B9_7F4A_7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58_476D_1CE4_E5B9
+        z = (z ^ (z >> 27)) &* 0x94D0_49BB_1331_11EB
+        return z ^ (z >> 31)
+    }
+
+    mutating func next(in range: ClosedRange<Int>) -> Int {
+        return range.lowerBound + Int(next() % UInt64(range.upperBound - range.lowerBound + 1))
+    }
+}
+
+/// Renders frame sequences that look like app screens: flat backgrounds, text set as
+/// glyph-sized blocks, hairline separators, and the scenario's moving part. Layout is in
+/// points of a 390 pt wide phone and scaled to the target width.
+public final class ScreenCorpusGenerator {
+
+    public static let framesPerSecond = 30
+
+    public let scenario: CorpusScenario
+    public let width: Int
+    public let height: Int
+    public let seed: UInt64
+    /// Pixels per layout point.
+    private let unit: Double
+
+    public init(scenario: CorpusScenario, width: Int, height: Int, seed: UInt64 = 1) {
+        precondition(width > 0 && height > 0 && width % 2 == 0 && height % 2 == 0,
+                     "corpus frames must have positive, even dimensions")
+        self.scenario = scenario
+        self.width = width
+        self.height = height
+        self.seed = seed
+        unit = Double(width) / 390
+    }
+
+    public convenience init(scenario: CorpusScenario, resolution: CorpusResolution, seed: UInt64 = 1) {
+        self.init(scenario: scenario, width: resolution.width, height: resolution.height, seed: seed)
+    }
+
+    // MARK: - Rendering
+
+    /// Tightly packed BGRA pixels of frame `index`.
+    public func render(frame index: Int) -> [UInt8] {
+        var pixels = [UInt8](repeating: 0, count: width * height * 4)
+        pixels.withUnsafeMutableBytes {
+            render(frame: index, into: $0.baseAddress!, bytesPerRow: width * 4)
+        }
+        return pixels
+    }
+
+    /// Draws frame `index` into a BGRA buffer of at least `height` rows.
+    public func render(frame index: Int, into base: UnsafeMutableRawPointer, bytesPerRow: Int) {
+        var canvas = Canvas(base: base, bytesPerRow: bytesPerRow, width: width, height: height)
+        switch scenario {
+        case .form:
+            drawFormPage(&canvas, originX: 0, caretVisible: (index / (ScreenCorpusGenerator.framesPerSecond / 2)) % 2 == 0)
+        case .list:
+            drawListPage(&canvas, originX: 0, scrollOffset: Double(index) * 8)
+        case .spinner:
+            drawListPage(&canvas, originX: 0, scrollOffset: 0)
+            drawSpinner(&canvas, frame: index)
+        case .transition:
+            drawTransition(&canvas, frame: index)
+        case .video:
+            drawFormPage(&canvas, originX: 0, caretVisible: false)
+            drawVideo(&canvas, frame: index)
+        }
+    }
+
+    // MARK: - Pages
+
+    private func points(_ value: Double) -> Int {
+        return Int((value * unit).rounded())
+    }
+
+    private func drawNavigationBar(_ canvas: inout Canvas, originX: Int, title: UInt64) {
+        canvas.fill(x: originX, y: 0, width: width, height: points(91), color: Palette.bar)
+        canvas.fill(x: originX, y: points(91), width: width, height: max(1, points(0.33)), color: Palette.separator)
+        drawText(&canvas, key: title, x: originX + points(140), y: points(58), maxWidth: points(110), size: 17, color: Palette.text)
+    }
+
+    private func drawFormPage(_ canvas: inout Canvas, originX: Int, caretVisible: Bool) {
+        canvas.fill(x: originX, y: 0, width: width, height: height, color: Palette.grouped)
+        drawNavigationBar(&canvas, originX: originX, title: 1)
+        var y = points(120)
+        for field in 0..<6 {
+            drawText(&canvas, key: 100 + UInt64(field), x: originX + points(20), y: y, maxWidth: points(160), size: 13, color: Palette.secondaryText)
+            y += points(22)
+            let fieldHeight = points(44)
+            canvas.fill(x: originX + points(16), y: y, width: width - points(32), height: fieldHeight, color: Palette.separator)
+            canvas.fill(x: originX + points(17), y: y + max(1, points(1)), width: width - points(34),
+                        height: fieldHeight - 2 * max(1, points(1)), color: Palette.background)
+            if field != 2 {
+                drawText(&canvas, key: 200 + UInt64(field), x: originX + points(28), y: y + points(13),
+                         maxWidth: width - points(80), size: 17, color: Palette.text)
+            } else if caretVisible {
+                canvas.fill(x: originX + points(28), y: y + points(11), width: max(1, points(2)), height: points(22), color: Palette.tint)
+            }
+            y += fieldHeight + points(18)
+        }
+        canvas.fill(x: originX + points(16), y: y + points(12), width: width - points(32), height: points(50), color: Palette.tint)
+        drawText(&canvas, key: 300, x: originX + points(150), y: y + points(28), maxWidth: points(90), size: 17, color: Palette.background)
+    }
+
+    private func drawListPage(_ canvas: inout Canvas, originX: Int, scrollOffset: Double) {
+        canvas.fill(x: originX, y: 0, width: width, height: height, color: Palette.background)
+        let top = points(92)
+        let rowHeight = 64.0
+        let firstRow = Int(scrollOffset / rowHeight)
+        var row = firstRow
+        while true {
+            let rowTop = top + points(Double(row) * rowHeight - scrollOffset)
+            guard rowTop < height else { break }
+            var random = SplitMix64(seed: seed &* 31 &+ UInt64(row))
+            let avatar = UInt32(truncatingIfNeeded: random.next()) | 0xFF80_8080
+            canvas.fill(x: originX + points(16), y: rowTop + points(10), width: points(44), height: points(44), color: avatar, clipTop: top)
+            drawText(&canvas, key: 1_000 + UInt64(row) * 2, x: originX + points(72), y: rowTop + points(12),
+                     maxWidth: points(220), size: 17, color: Palette.text, clipTop: top)
+            drawText(&canvas, key: 1_001 + UInt64(row) * 2, x: originX + points(72), y: rowTop + points(36),
+                     maxWidth: points(280), size: 13, color: Palette.secondaryText, clipTop: top)
+            canvas.fill(x: originX + points(72), y: rowTop + points(rowHeight) - 1, width: width - points(72), height: 1,
+                        color: Palette.separator, clipTop: top)
+            row += 1
+        }
+        drawNavigationBar(&canvas, originX: originX, title: 2)
+    }
+
+    // MARK: - Moving Parts
+
+    /// Eight dots on a circle; the bright one advances every two frames.
+    private func drawSpinner(_ canvas: inout Canvas, frame: Int) {
+        let centerX = width / 2
+        let centerY = height / 2
+        canvas.fill(x: centerX - points(50), y: centerY - points(50), width: points(100), height: points(100), color: Palette.hud)
+        let lead = (frame / 2) % 8
+        for dot in 0..<8 {
+            let angle = Double(dot) * .pi / 4
+            let x = centerX + points(cos(angle) * 22) - points(3)
+            let y = centerY + points(sin(angle) * 22) - points(3)
+            let age = UInt32((lead - dot + 8) % 8)
+            let shade = 0x30 + age * 0x18
+            canvas.fill(x: x, y: y, width: points(6), height: points(6), color: 0xFF00_0000 | shade << 16 | shade << 8 | shade)
+        }
+    }
+
+    private func drawTransition(_ canvas: inout Canvas, frame: Int) {
+        let t = frame % 60
+        guard t >= 30 && t < 48 else {
+            if t < 30 {
+                drawFormPage(&canvas, originX: 0, caretVisible: false)
+            } else {
+                drawListPage(&canvas, originX: 0, scrollOffset: 0)
+            }
+            return
+        }
+        // Ease-in-out push: the new page slides in over the old one, which drifts a third.
+        let linear = Double(t - 30 + 1) / 18
+        let progress = linear * linear * (3 - 2 * linear)
+        let incoming = Int((1 - progress) * Double(width))
+        canvas.clipMaxX = incoming
+        drawFormPage(&canvas, originX: -Int(progress * Double(width) / 3), caretVisible: false)
+        canvas.clipMaxX = width
+        canvas.fill(x: incoming - points(4), y: 0, width: points(4), height: height, color: Palette.separator)
+        canvas.clipMinX = incoming
+        drawListPage(&canvas, originX: incoming, scrollOffset: 0)
+        canvas.clipMinX = 0
+    }
+
+    /// A moving gradient with a bright object crossing it and light per-block noise.
+    private func drawVideo(_ canvas: inout Canvas, frame: Int) {
+        let left = points(16)
+        let top = points(180)
+        let videoWidth = width - 2 * left
+        let videoHeight = videoWidth * 9 / 16
+        let block = max(2, points(2))
+        var noise = SplitMix64(seed: seed ^ UInt64(frame) &* 0x2545_F491_4F6C_DD1D)
+        let objectX = (frame * points(6)) % videoWidth
+        var y = 0
+        while y < videoHeight {
+            var x = 0
+            while x < videoWidth {
+                let phase = (x + y + frame * points(3)) & 0xFF
+                let grain = UInt32(noise.next() & 0x0F)
+                let inObject = abs(x - objectX) < points(30) && abs(y - videoHeight / 2) < points(30)
+                let red = inObject ? 0xF0 : UInt32(phase / 2 + 40) + grain
+                let green = inObject ? 0xD0 : UInt32(80 + (y * 120 / videoHeight)) + grain
+                let blue = inObject ? 0x40 : UInt32(255 - phase / 2) - grain
+                canvas.fill(x: left + x, y: top + y, width: min(block, videoWidth - x), height: min(block, videoHeight - y),
+                            color: 0xFF00_0000 | red << 16 | green << 8 | blue)
+                x += block
+            }
+            y += block
+        }
+    }
+
+    // MARK: - Text
+
+    /// A line of text as word-shaped runs of glyph blocks. The same `key` always lays out
+    /// the same words.
+    private func drawText(_ canvas: inout Canvas, key: UInt64, x: Int, y: Int, maxWidth: Int, size: Double,
+                          color: UInt32, clipTop: Int = 0) {
+        var random = SplitMix64(seed: seed &* 0x1000_0001 &+ key)
+        let glyph = max(1, points(size * 0.55))
+        let capHeight = max(1, points(size * 0.7))
+        let gap = max(1, glyph / 5)
+        var cursor = x
+        let end = x + maxWidth
+        while cursor < end {
+            let letters = random.next(in: 2...9)
+            for _ in 0..<letters where cursor + glyph <= end {
+                // Some letters have ascenders or descenders.
+                let shape = random.next(in: 0...5)
+                let top = shape == 0 ? y - capHeight / 4 : y + (shape == 1 ? capHeight / 4 : 0)
+                let glyphHeight = shape == 1 ? capHeight : capHeight * 3 / 4 + (shape == 0 ? capHeight / 4 : 0)
+                canvas.fill(x: cursor, y: top, width: glyph - gap, height: glyphHeight, color: color, clipTop: clipTop)
+                cursor += glyph
+            }
+            cursor += glyph
+            if random.next(in: 0...6) == 0 { break }
+        }
+    }
+}
+
+// MARK: - Drawing
+
+private enum Palette {
+    static let background: UInt32 = 0xFFFF_FFFF
+    static let grouped: UInt32 = 0xFFF2_F2F7
+    static let bar: UInt32 = 0xFFF9_F9F9
+    static let separator: UInt32 = 0xFFC6_C6C8
+    static let text: UInt32 = 0xFF1C_1C1E
+    static let secondaryText: UInt32 = 0xFF8A_8A8E
+    static let tint: UInt32 = 0xFF00_7AFF
+    static let hud: UInt32 = 0xFFE5_E5EA
+}
+
+/// Solid rect fills on a BGRA buffer, clipped to the frame and a horizontal window.
+private struct Canvas {
+    let base: UnsafeMutableRawPointer
+    let bytesPerRow: Int
+    let width: Int
+    let height: Int
+    var clipMinX = 0
+    var clipMaxX: Int
+
+    init(base: UnsafeMutableRawPointer, bytesPerRow: Int, width: Int, height: Int) {
+        self.base = base
+        self.bytesPerRow = bytesPerRow
+        self.width = width
+        self.height = height
+        clipMaxX = width
+    }
+
+    /// `color` is 0xAARRGGBB, which little-endian stores as B, G, R, A.
+    func fill(x: Int, y: Int, width: Int, height: Int, color: UInt32, clipTop: Int = 0) {
+        let minX = max(x, clipMinX, 0)
+        let maxX = min(x + width, clipMaxX, self.width)
+        let minY = max(y, clipTop, 0)
+        let maxY = min(y + height, self.height)
+        guard minX < maxX && minY < maxY else { return }
+        for row in minY..<maxY {
+            (base + row * bytesPerRow + minX * 4).initializeMemory(as: UInt32.self, repeating: color.littleEndian, count: maxX - minX)
+        }
+    }
+}
@@ -0,0 +1,93 @@
+// swift-tools-version:5.7
+import PackageDescription
+
+// Headless build of the UIKit-free capture pipeline stages so they can be unit-tested and
+// benchmarked off-device (including on Linux). The SDK itself ships through CocoaPods.
+// Benchmark runner usage is described in Benchmarks/CaptureBenchmarks/main.swift.
+let package = Package(
+    name: "ShareScreenGrypp",
+    products: [
+        .library(name: "ShareScreenGryppCore", targets: ["ShareScreenGrypp"])
+    ],
+    targets: [
+        .target(
+            name: "ShareScreenGrypp",
+            path: "ShareScreenGrypp",
+            sources: [
+                "FrameTileHasher.swift",
+                "MonotonicClock.swift",
+                "CaptureRateScheduler.swift",
+                "FrameBufferPool.swift",
+                "CaptureStageTimings.swift",
+                "PixelConverter.swift",
+                "Downscaler.swift",
+                "BoundedFrameQueue.swift",
+                "LatencyHistogram.swift",
+                "FrameClock.swift",
+                "PixelRedactor.swift",
+                "BoxBlur.swift",
+                "SensitiveViewRegistry.swift",
+                "RedactionPolicy.swift",
+                "CaptureCoalescer.swift",
+                "CaptureStatistics.swift",
+                "CaptureGeometry.swift",
+                "DrawSignal.swift",
+                "DrawStreamDecoder.swift",
+                "AnnotationPath.swift",
+                "TimerWheel.swift",
+                "SessionTimers.swift",
+                "Log.swift",
+                "Benchmarking/PipelineBenchmarks.swift"
+            ]
+        ),
+        .target(
+            name: "ScreenCorpus",
+            path: "Benchmarks/ScreenCorpus"
+        ),
+        .target(
+            name: "AllocationCounter",
+            path: "Benchmarks/AllocationCounter"
+        ),
+        .executableTarget(
+            name: "GenerateScreenCorpus",
+            dependencies: ["ScreenCorpus"],
+            path: "Benchmarks/GenerateScreenCorpus"
+        ),
+        .executableTarget(
+            name: "CaptureBenchmarks",
+            dependencies: ["ShareScreenGrypp", "ScreenCorpus"],
+            path: "Benchmarks/CaptureBenchmarks"
+        ),
+        .testTarget(
+            name: "ShareScreenGryppTests",
+            dependencies: ["ShareScreenGrypp", "ScreenCorpus", "AllocationCounter"],
+            path: "ShareScreenGryppTests",
+            sources: [
+                "ShareScreenGryppTests.swift",
+                "FrameTileHasherTests.swift",
+                "CaptureRateSchedulerTests.swift",
+                "FrameBufferPoolTests.swift",
+                "PixelConverterTests.swift",
+                "DownscalerTests.swift",
+                "BoundedFrameQueueTests.swift",
+                "LatencyHistogramTests.swift",
+                "FrameClockTests.swift",
+                "PixelRedactorTests.swift",
+                "BoxBlurTests.swift",
+                "SensitiveViewRegistryTests.swift",
+                "RedactionPolicyTests.swift",
+                "CaptureCoalescerTests.swift",
+                "CaptureStatisticsTests.swift",
+                "CaptureGeometryTests.swift",
+                "DrawSignalTests.swift",
+                "ScreenCorpusTests.swift",
+                "DrawStreamDecoderTests.swift",
+                "AnnotationPathTests.swift",
+                "TimerWheelTests.swift",
+                "SessionTimersTests.swift",
+                "LogTests.swift",
+                "ScreenCapturerRedactionTests.swift"
+            ]
+        )
+    ]
+)
@@ -0,0 +1,280 @@
+import UIKit
+
+/// Live stroke counts and overlay redraw costs, in nanoseconds.
+public struct AnnotationStatistics {
+    /// Strokes on screen at full opacity, drawing or waiting to expire.
+    public internal(set) var liveStrokes = 0
+    public internal(set) var fadingStrokes = 0
+    /// Sublayers of the overlay: one per stroke style plus one per fading stroke.
+    public internal(set) var layers = 0
+    /// Ticks that rebuilt at least one style layer's path.
+    public internal(set) var redraws = 0
+    public internal(set) var redrawTime = LatencyHistogram()
+    /// From a stroke's first chunk arriving to the tick that first draws it.
+    public internal(set) var firstPixelLatency = LatencyHistogram()
+
+    public init() {}
+}
+
+/// Draws the agent's annotation strokes in one overlay layer on the window. Strokes that
+/// share a color and width are merged into a single shape layer, so the layer count
+/// follows the number of styles in use, not the number of strokes. Screen updates happen
+/// on one display-link tick: new segments are batched into at most one path rebuild per
+/// style per frame, and fading strokes step their opacity. Each stroke's fade starts
+/// from a session timer `lifetime` after it completes, so the display link only runs
+/// while something on screen is changing. Main thread only.
+final class AnnotationOverlay {
+
+    /// Seconds a completed stroke stays up before fading.
+    var lifetime: TimeInterval = 5
+    /// Seconds an incomplete stroke stays up waiting for its remaining chunks.
+    var incompleteLifetime: TimeInterval = 10
+    var fadeDuration: TimeInterval = 0.3
+
+    private struct Style: Hashable {
+        let color: String
+        let width: CGFloat
+    }
+
+    private final class Stroke {
+        let style: Style
+        let builder = AnnotationPathBuilder()
+        let path = CGMutablePath()
+        let firstChunkTime: UInt64
+        var isDrawn = false
+
+        init(style: Style, firstChunkTime: UInt64) {
+            self.style = style
+            self.firstChunkTime = firstChunkTime
+        }
+    }
+
+    private final class StyleLayer {
+        let layer = CAShapeLayer()
+        /// Stroke ids in drawing order.
+        var strokes: [String] = []
+        var isDirty = false
+    }
+
+    private struct Fade {
+        let layer: CAShapeLayer
+        let start: UInt64
+    }
+
+    private let clock: MonotonicClock
+    private let container = CALayer()
+    private var strokes: [String: Stroke] = [:]
+    private var styleLayers: [Style: StyleLayer] = [:]
+    private var fades: [Fade] = []
+    private let timers: SessionTimers<SessionTimer>
+    private var displayLink: CADisplayLink?
+    private var hasDirtyLayers = false
+
+    private var _statistics = AnnotationStatistics()
+
+    var statistics: AnnotationStatistics {
+        var copy = _statistics
+        copy.redrawTime = _statistics.redrawTime.detachedCopy()
+        copy.firstPixelLatency = _statistics.firstPixelLatency.detachedCopy()
+        return copy
+    }
+
+    // MARK: - Init
+    init(timers: SessionTimers<SessionTimer>, clock: MonotonicClock = SystemMonotonicClock.shared) {
+        self.timers = timers
+        self.clock = clock
+        container.name = "grypp"
+    }
+
+    deinit {
+        displayLink?.invalidate()
+    }
+
+    // MARK: - Strokes
+
+    /// Adds the segments of a streamed draw update to its stroke; they appear on the next
+    /// tick. The stroke takes its style from the update that brings its first segments.
+    func apply(_ update: DrawStreamUpdate, in window: UIWindow) {
+        let stroke: Stroke
+        if let existing = strokes[update.eventId] {
+            stroke = existing
+        } else {
+            guard !update.commands.isEmpty else { return }
+            let style = Style(color: update.stroke ?? "#ff7a00", width: update.strokeWidth ?? 5.0)
+            stroke = Stroke(style: style, firstChunkTime: update.firstChunkTime)
+            strokes[update.eventId] = stroke
+            scheduleFade(update.eventId, after: incompleteLifetime)
+            styleLayer(for: style, in: window).strokes.append(update.eventId)
+        }
+
+        let elements = stroke.builder.append(update.commands)
+        if !elements.isEmpty {
+            stroke.path.add(elements)
+            markDirty(stroke.style)
+        }
+        if update.isComplete {
+            scheduleFade(update.eventId, after: lifetime)
+        }
+        updateStatistics()
+        if hasDirtyLayers {
+            startTicking()
+        }
+    }
+
+    func removeAll() {
+        displayLink?.invalidate()
+        displayLink = nil
+        for eventId in strokes.keys {
+            timers.cancel(.stroke(eventId))
+        }
+        strokes.removeAll()
+        styleLayers.removeAll()
+        fades.removeAll()
+        hasDirtyLayers = false
+        container.sublayers?.forEach { $0.removeFromSuperlayer() }
+        container.removeFromSuperlayer()
+        updateStatistics()
+    }
+
+    private func styleLayer(for style: Style, in window: UIWindow) -> StyleLayer {
+        if container.superlayer !== window.layer {
+            window.layer.addSublayer(container)
+        }
+        if let existing = styleLayers[style] {
+            return existing
+        }
+        let styleLayer = StyleLayer()
+        configure(styleLayer.layer, style: style)
+        container.addSublayer(styleLayer.layer)
+        styleLayers[style] = styleLayer
+        return styleLayer
+    }
+
+    private func configure(_ layer: CAShapeLayer, style: Style) {
+        layer.strokeColor = UIColor(hex: style.color).cgColor
+        layer.fillColor = UIColor.clear.cgColor
+        layer.lineWidth = style.width
+        layer.lineCap = .round
+        layer.lineJoin = .round
+    }
+
+    private func markDirty(_ style: Style) {
+        styleLayers[style]?.isDirty = true
+        hasDirtyLayers = true
+    }
+
+    // MARK: - Tick
+
+    private func startTicking() {
+        guard displayLink == nil else { return }
+        let link = CADisplayLink(target: DisplayLinkTarget(self), selector: #selector(DisplayLinkTarget.tick))
+        link.add(to: .main, forMode: .common)
+        displayLink = link
+    }
+
+    fileprivate func tick() {
+        let now = clock.nanoseconds
+        CATransaction.begin()
+        CATransaction.setDisableActions(true)
+        stepFades(now: now)
+        if hasDirtyLayers {
+            redraw(now: now)
+        }
+        CATransaction.commit()
+
+        updateStatistics()
+        if !hasDirtyLayers && fades.isEmpty {
+            displayLink?.invalidate()
+            displayLink = nil
+            if strokes.isEmpty {
+                container.removeFromSuperlayer()
+            }
+        }
+    }
+
+    /// Rebuilds the merged path of every style layer that gained or lost segments.
+    private func redraw(now: UInt64) {
+        let start = clock.nanoseconds
+        for (style, styleLayer) in styleLayers where styleLayer.isDirty {
+            styleLayer.isDirty = false
+            guard !styleLayer.strokes.isEmpty else {
+                styleLayer.layer.removeFromSuperlayer()
+                styleLayers.removeValue(forKey: style)
+                continue
+            }
+            let merged = CGMutablePath()
+            for eventId in styleLayer.strokes {
+                guard let stroke = strokes[eventId] else { continue }
+                merged.addPath(stroke.path)
+                if !stroke.isDrawn && !stroke.path.isEmpty {
+                    stroke.isDrawn = true
+                    _statistics.firstPixelLatency.record(now &- stroke.firstChunkTime)
+                }
+            }
+            styleLayer.layer.path = merged
+        }
+        hasDirtyLayers = false
+        _statistics.redraws += 1
+        _statistics.redrawTime.record(clock.nanoseconds - start)
+    }
+
+    // MARK: - Fading
+
+    /// Starts the stroke's fade `delay` seconds from now, replacing any earlier deadline.
+    private func scheduleFade(_ eventId: String, after delay: TimeInterval) {
+        timers.schedule(.stroke(eventId), after: delay) { [weak self] in
+            guard let self = self else { return }
+            self.beginFade(eventId, now: self.clock.nanoseconds)
+            self.updateStatistics()
+            self.startTicking()
+        }
+    }
+
+    /// Moves an expired stroke out of its style layer into a layer of its own to fade.
+    private func beginFade(_ eventId: String, now: UInt64) {
+        guard let stroke = strokes.removeValue(forKey: eventId),
+              let styleLayer = styleLayers[stroke.style] else { return }
+        styleLayer.strokes.removeAll { $0 == eventId }
+        markDirty(stroke.style)
+        guard stroke.isDrawn, fadeDuration > 0 else { return }
+        let layer = CAShapeLayer()
+        configure(layer, style: stroke.style)
+        layer.path = stroke.path
+        container.addSublayer(layer)
+        fades.append(Fade(layer: layer, start: now))
+    }
+
+    private func stepFades(now: UInt64) {
+        guard !fades.isEmpty else { return }
+        let duration = Double(fadeDuration) * 1_000_000_000
+        fades.removeAll { fade in
+            let progress = Double(now &- fade.start) / duration
+            guard progress < 1 else {
+                fade.layer.removeFromSuperlayer()
+                return true
+            }
+            fade.layer.opacity = Float(1 - progress)
+            return false
+        }
+    }
+
+    private func updateStatistics() {
+        _statistics.liveStrokes = strokes.count
+        _statistics.fadingStrokes = fades.count
+        _statistics.layers = container.sublayers?.count ?? 0
+    }
+}
+
+/// Holds the overlay weakly, so the display link's strong reference to its target
+/// doesn't keep the overlay alive.
+private final class DisplayLinkTarget: NSObject {
+    private weak var overlay: AnnotationOverlay?
+
+    init(_ overlay: AnnotationOverlay) {
+        self.overlay = overlay
+    }
+
+    @objc func tick() {
+        overlay?.tick()
+    }
+}
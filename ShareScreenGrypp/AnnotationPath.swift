@@ -0,0 +1,171 @@
+import Foundation
+
+enum AnnotationPathElement: Equatable {
+    case move(to: CGPoint)
+    case line(to: CGPoint)
+    case quadCurve(to: CGPoint, control: CGPoint)
+    case curve(to: CGPoint, control1: CGPoint, control2: CGPoint)
+    case closeSubpath
+}
+
+/// Turns Fabric path commands (`M`, `L`, `Q`, `C`, `Z`, absolute or relative) into path
+/// elements, keeping curves as curves, and drops detail finer than `tolerance` with
+/// Ramer–Douglas–Peucker on the segment end points: a run of segments becomes one line
+/// when every end point and control point in it is within `tolerance` of that line.
+/// Since a Bézier segment lies inside the hull of its control points, the simplified
+/// outline stays within `tolerance` of the original, and dense freehand strokes shrink
+/// to roughly one element per bend.
+///
+/// Commands can be appended in batches as a stroke streams in; each batch is simplified
+/// on its own, so batch boundaries are always kept.
+final class AnnotationPathBuilder {
+
+    /// Maximum distance, in points, between the drawn and the original outline.
+    let tolerance: CGFloat
+    private(set) var elementCount = 0
+    private(set) var commandCount = 0
+    private var current: CGPoint?
+    private var subpathStart: CGPoint?
+
+    /// A segment from the previous end point to `end`, as parsed.
+    private struct Segment {
+        let element: AnnotationPathElement
+        let end: CGPoint
+
+        /// Squared distance of the farthest control point from the segment `start`–`end`.
+        func squaredControlDistance(toSegment start: CGPoint, _ end: CGPoint) -> CGFloat {
+            switch element {
+            case let .quadCurve(_, control):
+                return AnnotationPathBuilder.squaredDistance(from: control, toSegment: start, end)
+            case let .curve(_, control1, control2):
+                return max(AnnotationPathBuilder.squaredDistance(from: control1, toSegment: start, end),
+                           AnnotationPathBuilder.squaredDistance(from: control2, toSegment: start, end))
+            default:
+                return 0
+            }
+        }
+    }
+
+    // MARK: - Init
+    init(tolerance: CGFloat = 0.5) {
+        self.tolerance = max(tolerance, 0)
+    }
+
+    /// Parses and simplifies `commands`, continuing from the end of the previous batch,
+    /// and returns the elements to add to the path.
+    func append(_ commands: [[PathCommandValue]]) -> [AnnotationPathElement] {
+        var elements: [AnnotationPathElement] = []
+        var run: [Segment] = []
+        var runStart = current
+        for command in commands {
+            guard case let .string(name)? = command.first, let letter = name.first else { continue }
+            let numbers = command.dropFirst().compactMap { value -> CGFloat? in
+                if case let .number(number) = value { return number }
+                return nil
+            }
+            let arity: Int
+            switch letter {
+            case "M", "m", "L", "l": arity = 2
+            case "Q", "q": arity = 4
+            case "C", "c": arity = 6
+            case "Z", "z": arity = 0
+            default: continue
+            }
+            let startsSubpath = letter == "M" || letter == "m"
+            guard numbers.count >= arity, startsSubpath || current != nil else { continue }
+            let origin = letter.isLowercase ? (current ?? .zero) : .zero
+            func point(_ index: Int) -> CGPoint {
+                return CGPoint(x: origin.x + numbers[index], y: origin.y + numbers[index + 1])
+            }
+            commandCount += 1
+
+            switch letter {
+            case "M", "m":
+                flush(&run, from: runStart, into: &elements)
+                let to = point(0)
+                elements.append(.move(to: to))
+                current = to
+                subpathStart = to
+                runStart = to
+            case "Z", "z":
+                flush(&run, from: runStart, into: &elements)
+                elements.append(.closeSubpath)
+                current = subpathStart
+                runStart = current
+            case "L", "l":
+                let to = point(0)
+                run.append(Segment(element: .line(to: to), end: to))
+                current = to
+            case "Q", "q":
+                let to = point(2)
+                run.append(Segment(element: .quadCurve(to: to, control: point(0)), end: to))
+                current = to
+            default:
+                let to = point(4)
+                run.append(Segment(element: .curve(to: to, control1: point(0), control2: point(2)), end: to))
+                current = to
+            }
+        }
+        flush(&run, from: runStart, into: &elements)
+        elementCount += elements.count
+        return elements
+    }
+
+    // MARK: - Simplification
+
+    /// Appends the simplified `run`, which starts at `start`, and empties it.
+    private func flush(_ run: inout [Segment], from start: CGPoint?, into elements: inout [AnnotationPathElement]) {
+        guard let start = start, !run.isEmpty else {
+            run.removeAll(keepingCapacity: true)
+            return
+        }
+        // Anchor 0 is `start`; anchor i > 0 is the end of run[i - 1].
+        var kept = [Bool](repeating: false, count: run.count + 1)
+        kept[0] = true
+        kept[run.count] = true
+        var spans = [(0, run.count)]
+        let limit = tolerance * tolerance
+        while let (first, last) = spans.popLast() {
+            guard last - first > 1 else { continue }
+            let from = first == 0 ? start : run[first - 1].end
+            let to = run[last - 1].end
+            var farthest = first + 1
+            var farthestDistance: CGFloat = -1
+            var maximum: CGFloat = 0
+            for index in first..<last {
+                maximum = max(maximum, run[index].squaredControlDistance(toSegment: from, to))
+                guard index + 1 < last else { continue }
+                let distance = AnnotationPathBuilder.squaredDistance(from: run[index].end, toSegment: from, to)
+                maximum = max(maximum, distance)
+                if distance > farthestDistance {
+                    farthestDistance = distance
+                    farthest = index + 1
+                }
+            }
+            guard maximum > limit else { continue }
+            kept[farthest] = true
+            spans.append((first, farthest))
+            spans.append((farthest, last))
+        }
+
+        var previous = 0
+        for anchor in 1...run.count where kept[anchor] {
+            elements.append(anchor - previous == 1 ? run[anchor - 1].element : .line(to: run[anchor - 1].end))
+            previous = anchor
+        }
+        run.removeAll(keepingCapacity: true)
+    }
+
+    static func squaredDistance(from point: CGPoint, toSegment start: CGPoint, _ end: CGPoint) -> CGFloat {
+        let dx = end.x - start.x
+        let dy = end.y - start.y
+        let lengthSquared = dx * dx + dy * dy
+        var t: CGFloat = 0
+        if lengthSquared > 0 {
+            t = min(max(((point.x - start.x) * dx + (point.y - start.y) * dy) / lengthSquared, 0), 1)
+        }
+        let x = start.x + t * dx - point.x
+        let y = start.y + t * dy - point.y
+        return x * x + y * y
+    }
+}
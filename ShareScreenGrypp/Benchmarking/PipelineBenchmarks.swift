@@ -0,0 +1,304 @@
+import Foundation
+
+// Built into the Swift package only, not the SDK, so the CaptureBenchmarks runner can
+// time internal stages through a small public surface instead of `@testable import`.
+
+/// One timed stage.
+public struct PipelineBenchmark {
+    public let name: String
+    /// Builds the synthetic input once and returns the body to time.
+    public let setUp: () -> () -> Void
+}
+
+/// The UIKit-free stages of the capture and annotation pipelines, on synthetic inputs
+/// sized like a 3x iPhone capture (1290x2796 points rasterized, 592x1280 sent).
+public enum PipelineBenchmarks {
+
+    static let outputWidth = 592
+    static let outputHeight = 1280
+
+    public static var all: [PipelineBenchmark] {
+        return [
+            PipelineBenchmark(name: "geometry.output_size", setUp: outputGeometry),
+            PipelineBenchmark(name: "resize.area_1290x2796", setUp: { resize(width: 1290, height: 2796) }),
+            PipelineBenchmark(name: "resize.halve_1184x2560", setUp: { resize(width: outputWidth * 2, height: outputHeight * 2) }),
+            PipelineBenchmark(name: "conversion.nv12", setUp: conversion),
+            PipelineBenchmark(name: "redaction.fill_10_rects", setUp: { redaction(.fill) }),
+            PipelineBenchmark(name: "redaction.mosaic_10_rects", setUp: { redaction(.mosaic) }),
+            PipelineBenchmark(name: "redaction.blur_10_rects", setUp: { redaction(.blur) }),
+            PipelineBenchmark(name: "tile_hash.static", setUp: { tileHash(changing: false) }),
+            PipelineBenchmark(name: "tile_hash.scrolling", setUp: { tileHash(changing: true) }),
+            PipelineBenchmark(name: "draw_path.decode_500_points", setUp: drawPathDecode),
+            PipelineBenchmark(name: "draw_path.stream_500_points_8_chunks", setUp: drawPathStream),
+            PipelineBenchmark(name: "draw_path.simplify_pencil_2000_samples", setUp: pencilSimplify),
+            PipelineBenchmark(name: "draw_chunks.reassemble_100x8", setUp: chunkReassembly),
+            PipelineBenchmark(name: "timers.100k_schedule_rearm_cancel_fire", setUp: sessionTimers),
+            PipelineBenchmark(name: "log.disabled_1m", setUp: disabledLogging),
+            PipelineBenchmark(name: "log.enabled_10k", setUp: enabledLogging)
+        ]
+    }
+
+    // MARK: - Inputs
+
+    /// A leased frame with text-like bands and a gradient, so kernels see realistic data.
+    static func makeFrame(_ pool: FrameBufferPool, width: Int, height: Int, offset: Int = 0) -> FrameBuffer {
+        let buffer = pool.lease(width: width, height: height)!
+        for y in 0..<height {
+            let row = (buffer.baseAddress() + y * buffer.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+            let band = (y + offset) % 48 < 18
+            for x in 0..<width {
+                let shade = band && x % 7 != 0 ? UInt8(40) : UInt8(truncatingIfNeeded: 200 + (x >> 5))
+                row[x * 4] = shade
+                row[x * 4 + 1] = shade
+                row[x * 4 + 2] = UInt8(truncatingIfNeeded: shade &+ UInt8(truncatingIfNeeded: y >> 4))
+                row[x * 4 + 3] = 0xFF
+            }
+        }
+        return buffer
+    }
+
+    /// A Fabric path object with `points` quadratic segments, base64-encoded like a draw
+    /// signal payload.
+    static func fabricPayload(points: Int) -> String {
+        var path: [String] = ["[\"M\",100.5,200.25]"]
+        for index in 1..<points {
+            let x = 100.5 + Double(index) * 1.75
+            let y = 200.25 + sin(Double(index) / 12) * 80
+            path.append("[\"Q\",\(x - 0.875),\(y + 0.5),\(x),\(y)]")
+        }
+        let json = "{\"stroke\":\"#ff7a00\",\"strokeWidth\":5,\"path\":[\(path.joined(separator: ","))]}"
+        return Data(json.utf8).base64EncodedString()
+    }
+
+    /// A freehand stroke as Fabric's pencil brush sends it: a quadratic through the
+    /// midpoint of each pair of pointer samples, here from a looping signature-like trace
+    /// with sub-point jitter, base64-encoded like a draw signal payload.
+    static func fabricPencilPayload(samples: Int) -> String {
+        var state: UInt64 = 0x9E37_79B9_7F4A_7C15
+        func jitter() -> Double {
+            state = state &* 6364136223846793005 &+ 1442695040888963407
+            return Double(state >> 40) / Double(1 << 24) * 0.3 - 0.15
+        }
+        let points: [(x: Double, y: Double)] = (0..<samples).map { index in
+            let t = Double(index) / 40
+            return (60 + t * 24 + 50 * sin(t * 2.3) + jitter(), 400 + 80 * sin(t * 1.1) * cos(t * 0.4) + jitter())
+        }
+        var path: [String] = ["[\"M\",\(points[0].x),\(points[0].y)]"]
+        for index in 1..<(samples - 1) {
+            let control = points[index]
+            let next = points[index + 1]
+            path.append("[\"Q\",\(control.x),\(control.y),\((control.x + next.x) / 2),\((control.y + next.y) / 2)]")
+        }
+        path.append("[\"L\",\(points[samples - 1].x),\(points[samples - 1].y)]")
+        let json = "{\"stroke\":\"#ff7a00\",\"strokeWidth\":5,\"path\":[\(path.joined(separator: ","))]}"
+        return Data(json.utf8).base64EncodedString()
+    }
+
+    // MARK: - Corpus
+
+    /// The background stage of `ScreenCapturer` in its default single-pass mode (dirty
+    /// check and, for changed frames, NV12 conversion) over `frameCount` frames of a view
+    /// `viewWidth` by `viewHeight` pixels. `render(index, base, bytesPerRow)` draws frame
+    /// `index` at the output size, given by `outputSize(viewWidth:viewHeight:)`; frames are
+    /// rendered here, so only the pipeline is timed.
+    public static func corpusPipeline(viewWidth: Int, viewHeight: Int, frameCount: Int,
+                                      render: (Int, UnsafeMutableRawPointer, Int) -> Void) -> () -> Void {
+        let (width, height) = outputSize(viewWidth: viewWidth, viewHeight: viewHeight)
+        let pool = FrameBufferPool(capacity: frameCount, maximumRetainedKeys: 2)
+        let rasters: [FrameBuffer] = (0..<frameCount).map { index in
+            let raster = pool.lease(width: width, height: height)!
+            render(index, raster.baseAddress(), raster.bytesPerRow())
+            return raster
+        }
+        let yuv = pool.lease(width: width, height: height, format: .nv12)!
+        let hasher = FrameTileHasher()
+        return {
+            hasher.reset()
+            var sent = 0
+            for raster in rasters {
+                let report = hasher.update(baseAddress: raster.baseAddress(), width: raster.width,
+                                           height: raster.height, bytesPerRow: raster.bytesPerRow())
+                if report.isDirty {
+                    PixelConverter.convert(raster, into: yuv)
+                    sent += 1
+                }
+            }
+            blackHole(sent)
+        }
+    }
+
+    /// The size a view of this many pixels is sent at.
+    public static func outputSize(viewWidth: Int, viewHeight: Int) -> (width: Int, height: Int) {
+        let geometry = CaptureGeometry(viewSize: CGSize(width: viewWidth, height: viewHeight), maximumDimension: 1280)
+        return (geometry.outputWidth, geometry.outputHeight)
+    }
+
+    // MARK: - Stages
+
+    private static func outputGeometry() -> () -> Void {
+        let sizes = (0..<1_000).map { CGSize(width: 320 + $0 % 700, height: 480 + ($0 * 7) % 900) }
+        return {
+            var total = 0
+            for size in sizes {
+                let geometry = CaptureGeometry(viewSize: size, maximumDimension: 1280)
+                total &+= geometry.outputWidth &+ geometry.outputHeight
+            }
+            blackHole(total)
+        }
+    }
+
+    private static func resize(width: Int, height: Int) -> () -> Void {
+        let pool = FrameBufferPool(capacity: 1, maximumRetainedKeys: 2)
+        let source = makeFrame(pool, width: width, height: height)
+        let destination = pool.lease(width: outputWidth, height: outputHeight)!
+        let downscaler = Downscaler(mode: .areaAverage)
+        return { downscaler.scale(source, into: destination) }
+    }
+
+    private static func conversion() -> () -> Void {
+        let pool = FrameBufferPool(capacity: 1, maximumRetainedKeys: 2)
+        let source = makeFrame(pool, width: outputWidth, height: outputHeight)
+        let destination = pool.lease(width: outputWidth, height: outputHeight, format: .nv12)!
+        return { PixelConverter.convert(source, into: destination) }
+    }
+
+    /// Ten field-sized rects, as on a checkout form.
+    private static func redaction(_ action: RedactionAction) -> () -> Void {
+        let pool = FrameBufferPool(capacity: 1, maximumRetainedKeys: 1)
+        let frame = makeFrame(pool, width: outputWidth, height: outputHeight)
+        let redactor = PixelRedactor()
+        let regions = (0..<10).map {
+            RedactionRegion(rect: PixelRect(x: 40, y: 200 + $0 * 90, width: 512, height: 56), action: action)
+        }
+        return { redactor.apply(regions, in: frame, color: .translucentBlack) }
+    }
+
+    private static func tileHash(changing: Bool) -> () -> Void {
+        let pool = FrameBufferPool(capacity: 2, maximumRetainedKeys: 1)
+        let frames = [makeFrame(pool, width: outputWidth, height: outputHeight),
+                      makeFrame(pool, width: outputWidth, height: outputHeight, offset: changing ? 9 : 0)]
+        let hasher = FrameTileHasher()
+        var next = 0
+        return {
+            let frame = frames[next]
+            next ^= 1
+            blackHole(hasher.update(baseAddress: frame.baseAddress(), width: frame.width,
+                                    height: frame.height, bytesPerRow: frame.bytesPerRow()).changedTiles)
+        }
+    }
+
+    private static func drawPathDecode() -> () -> Void {
+        let payload = fabricPayload(points: 500)
+        return {
+            guard let path = FabricPathObject.decode(fromBase64: payload) else { fatalError("payload must decode") }
+            blackHole(extractPoints(from: path.path).count)
+        }
+    }
+
+    /// The same stroke decoded chunk by chunk as it would stream in.
+    private static func drawPathStream() -> () -> Void {
+        let payload = Array(fabricPayload(points: 500))
+        let chunkLength = (payload.count + 7) / 8
+        let chunks = stride(from: 0, to: payload.count, by: chunkLength).map {
+            String(payload[$0..<min($0 + chunkLength, payload.count)])
+        }
+        return {
+            let decoder = DrawStreamDecoder()
+            var count = 0
+            for chunk in chunks {
+                count += extractPoints(from: decoder.feed(chunk)).count
+            }
+            precondition(count == 500, "every point must decode")
+        }
+    }
+
+    private static func pencilSimplify() -> () -> Void {
+        guard let path = FabricPathObject.decode(fromBase64: fabricPencilPayload(samples: 2_000))?.path else {
+            fatalError("payload must decode")
+        }
+        return { blackHole(AnnotationPathBuilder().append(path).count) }
+    }
+
+    /// 100 strokes of eight chunks each, arriving interleaved and out of order.
+    private static func chunkReassembly() -> () -> Void {
+        let payload = fabricPayload(points: 200)
+        let chunkLength = (payload.count + 7) / 8
+        var signals: [DrawEndSignal] = []
+        for event in 0..<100 {
+            for order in [3, 0, 7, 1, 5, 2, 6, 4] {
+                let start = payload.index(payload.startIndex, offsetBy: min(order * chunkLength, payload.count))
+                let end = payload.index(start, offsetBy: min(chunkLength, payload.distance(from: start, to: payload.endIndex)))
+                signals.append(DrawEndSignal(action: "draw", eventId: "stroke-\(event)", order: order,
+                                             totalChunks: 8, value: String(payload[start..<end])))
+            }
+        }
+        var interleaved: [DrawEndSignal] = []
+        for round in 0..<8 {
+            for event in 0..<100 {
+                interleaved.append(signals[event * 8 + round])
+            }
+        }
+        return {
+            let assembler = DrawChunkAssembler()
+            var completed = 0
+            for signal in interleaved where assembler.insert(signal) != nil {
+                completed += 1
+            }
+            precondition(completed == 100 && assembler.pendingEventCount == 0, "every stroke must complete")
+        }
+    }
+
+    /// 100,000 keyed timers over ten minutes: schedule all, re-arm half, cancel a quarter,
+    /// then run a virtual clock past every deadline.
+    private static func sessionTimers() -> () -> Void {
+        let delays = (0..<100_000).map { TimeInterval(($0 &* 7_919) % 600_000) / 1000 }
+        let clock = ManualClock(nanoseconds: 1_000_000_000)
+        return {
+            let timers = SessionTimers<Int>(tickDuration: 0.01, clock: clock, queue: nil)
+            var fired = 0
+            for (key, delay) in delays.enumerated() {
+                timers.schedule(key, after: delay) { fired += 1 }
+            }
+            for key in stride(from: 0, to: delays.count, by: 2) {
+                timers.schedule(key, after: delays[key] / 2) { fired += 1 }
+            }
+            for key in stride(from: 1, to: delays.count, by: 4) {
+                timers.cancel(key)
+            }
+            clock.advance(by: 601_000_000_000)
+            timers.fireDueTimers()
+            precondition(fired == 75_000, "every remaining timer must fire")
+        }
+    }
+
+    /// Filtered-out calls with interpolated messages, as on the touch path in release.
+    private static func disabledLogging() -> () -> Void {
+        let log = Logger(category: "benchmark")
+        let point = CGPoint(x: 12.5, y: 99)
+        return {
+            LogCenter.shared.minimumLevel = .error
+            for index in 0..<1_000_000 {
+                log.trace("Touch point: \(point) \(index)")
+                log.info("Touch point: \(point) \(index)")
+            }
+            LogCenter.shared.minimumLevel = .trace
+        }
+    }
+
+    private static func enabledLogging() -> () -> Void {
+        let log = Logger(category: "benchmark")
+        return {
+            LogCenter.shared.sink = { _ in }
+            for index in 0..<10_000 {
+                log.info("Touch point \(index)")
+            }
+            LogCenter.shared.flush()
+        }
+    }
+
+    /// Keeps results alive so the optimizer can't drop the work that produced them.
+    @inline(never)
+    static func blackHole<T>(_ value: T) {
+        _ = value
+    }
+}
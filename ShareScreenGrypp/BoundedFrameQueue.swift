@@ -0,0 +1,87 @@
+import Foundation
+
+/// Fixed-capacity FIFO handing frames from one producer thread to one consumer thread.
+/// When the consumer falls behind, `push(_:)` discards the oldest entry instead of
+/// blocking the producer, so the main thread never waits on the background stage and the
+/// consumer always works on the freshest frames.
+final class BoundedFrameQueue<Element> {
+
+    struct Counters {
+        var pushed = 0
+        var popped = 0
+        /// Entries discarded to make room for a newer one.
+        var dropped = 0
+        var maximumDepth = 0
+    }
+
+    let capacity: Int
+
+    private let lock = NSLock()
+    private var storage: [Element?]
+    private var head = 0
+    private var depth = 0
+    private var _counters = Counters()
+
+    // MARK: - Init
+    init(capacity: Int) {
+        precondition(capacity > 0, "capacity must be positive")
+        self.capacity = capacity
+        storage = [Element?](repeating: nil, count: capacity)
+    }
+
+    var count: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return depth
+    }
+
+    var counters: Counters {
+        lock.lock()
+        defer { lock.unlock() }
+        return _counters
+    }
+
+    // MARK: - Push/Pop
+
+    /// Appends `element` and returns the entry it displaced when the queue was full, so
+    /// the caller can release whatever that entry holds.
+    @discardableResult
+    func push(_ element: Element) -> Element? {
+        lock.lock()
+        defer { lock.unlock() }
+        var evicted: Element?
+        if depth == capacity {
+            evicted = storage[head]
+            storage[head] = nil
+            head = (head + 1) % capacity
+            depth -= 1
+            _counters.dropped += 1
+        }
+        storage[(head + depth) % capacity] = element
+        depth += 1
+        _counters.pushed += 1
+        _counters.maximumDepth = max(_counters.maximumDepth, depth)
+        return evicted
+    }
+
+    func pop() -> Element? {
+        lock.lock()
+        defer { lock.unlock() }
+        guard depth > 0 else { return nil }
+        let element = storage[head]
+        storage[head] = nil
+        head = (head + 1) % capacity
+        depth -= 1
+        _counters.popped += 1
+        return element
+    }
+
+    /// Empties the queue, oldest first.
+    func removeAll() -> [Element] {
+        var elements: [Element] = []
+        while let element = pop() {
+            elements.append(element)
+        }
+        return elements
+    }
+}
@@ -0,0 +1,126 @@
+import Foundation
+
+/// Blurs rectangular regions of a BGRA frame in place with three passes of a separable box
+/// filter, which approximates a Gaussian with sigma ≈ radius * 0.8 (for radius ≥ 2).
+///
+/// Only the target rect plus a `3 * radius` apron is read, and only the target rect is
+/// written, so the cost follows the redacted area rather than the frame size. Scratch
+/// storage is kept between calls.
+final class BoxBlur {
+
+    static let passes = 3
+
+    let radius: Int
+
+    // MARK: - Scratch
+    private var front: [UInt8] = []
+    private var back: [UInt8] = []
+    private var columnSums: [SIMD4<Int32>] = []
+
+    // MARK: - Init
+    init(radius: Int = 6) {
+        precondition(radius > 0, "radius must be positive")
+        self.radius = radius
+    }
+
+    // MARK: - Blur
+
+    func blur(_ rect: PixelRect, in buffer: FrameBuffer) {
+        precondition(buffer.format == .bgra, "only BGRA frames can be blurred")
+        let target = rect.clipped(width: buffer.width, height: buffer.height)
+        guard !target.isEmpty else { return }
+        let apron = radius * BoxBlur.passes
+        let region = PixelRect(x: target.x - apron, y: target.y - apron,
+                               width: target.width + 2 * apron, height: target.height + 2 * apron)
+            .clipped(width: buffer.width, height: buffer.height)
+
+        let rowBytes = region.width * 4
+        let byteCount = rowBytes * region.height
+        if front.count < byteCount {
+            front = [UInt8](repeating: 0, count: byteCount)
+            back = [UInt8](repeating: 0, count: byteCount)
+        }
+        if columnSums.count < region.width {
+            columnSums = [SIMD4<Int32>](repeating: .zero, count: region.width)
+        }
+
+        front.withUnsafeMutableBytes { front in
+            back.withUnsafeMutableBytes { back in
+                columnSums.withUnsafeMutableBufferPointer { sums in
+                    let a = front.baseAddress!
+                    let b = back.baseAddress!
+                    for y in 0..<region.height {
+                        let source = buffer.baseAddress() + (region.y + y) * buffer.bytesPerRow() + region.x * 4
+                        (a + y * rowBytes).copyMemory(from: source, byteCount: rowBytes)
+                    }
+                    for _ in 0..<BoxBlur.passes {
+                        for y in 0..<region.height {
+                            BoxBlur.horizontalPass(from: a + y * rowBytes, to: b + y * rowBytes,
+                                                   width: region.width, radius: radius)
+                        }
+                        BoxBlur.verticalPass(from: b, to: a, width: region.width, height: region.height,
+                                             radius: radius, sums: sums.baseAddress!)
+                    }
+                    for y in 0..<target.height {
+                        let destination = buffer.baseAddress() + (target.y + y) * buffer.bytesPerRow() + target.x * 4
+                        let blurred = a + (target.y - region.y + y) * rowBytes + (target.x - region.x) * 4
+                        destination.copyMemory(from: blurred, byteCount: target.width * 4)
+                    }
+                }
+            }
+        }
+    }
+
+    // MARK: - Kernels
+
+    @inline(__always)
+    private static func load(_ row: UnsafeMutableRawPointer, _ x: Int) -> SIMD4<Int32> {
+        return SIMD4<Int32>(truncatingIfNeeded: UnsafeRawPointer(row).loadUnaligned(fromByteOffset: x * 4, as: SIMD4<UInt8>.self))
+    }
+
+    @inline(__always)
+    private static func average(_ sum: SIMD4<Int32>, _ window: Int32) -> SIMD4<UInt8> {
+        return SIMD4<UInt8>(truncatingIfNeeded: (sum &+ window / 2) / window)
+    }
+
+    /// Running-sum box filter along one row; edge pixels repeat.
+    private static func horizontalPass(from source: UnsafeMutableRawPointer, to destination: UnsafeMutableRawPointer,
+                                       width: Int, radius: Int) {
+        let window = Int32(2 * radius + 1)
+        var sum = load(source, 0) &* Int32(radius + 1)
+        for x in 1...radius {
+            sum &+= load(source, min(x, width - 1))
+        }
+        for x in 0..<width {
+            destination.storeBytes(of: average(sum, window), toByteOffset: x * 4, as: SIMD4<UInt8>.self)
+            sum &+= load(source, min(x + radius + 1, width - 1)) &- load(source, max(x - radius, 0))
+        }
+    }
+
+    /// Same filter down the columns, walking rows in order with one running sum per column
+    /// so memory is read sequentially.
+    private static func verticalPass(from source: UnsafeMutableRawPointer, to destination: UnsafeMutableRawPointer,
+                                     width: Int, height: Int, radius: Int, sums: UnsafeMutablePointer<SIMD4<Int32>>) {
+        let rowBytes = width * 4
+        let window = Int32(2 * radius + 1)
+        func row(_ y: Int) -> UnsafeMutableRawPointer {
+            return source + min(max(y, 0), height - 1) * rowBytes
+        }
+        for x in 0..<width {
+            var sum = load(row(0), x) &* Int32(radius + 1)
+            for y in 1...radius {
+                sum &+= load(row(y), x)
+            }
+            sums[x] = sum
+        }
+        for y in 0..<height {
+            let output = destination + y * rowBytes
+            let entering = row(y + radius + 1)
+            let leaving = row(y - radius)
+            for x in 0..<width {
+                output.storeBytes(of: average(sums[x], window), toByteOffset: x * 4, as: SIMD4<UInt8>.self)
+                sums[x] &+= load(entering, x) &- load(leaving, x)
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+import Foundation
+
+/// Turns UI update signals (run-loop commits) into capture deadlines. The first update
+/// after a capture is captured as soon as the rate cap allows; updates arriving before
+/// then fold into that same capture. Touches and animations, which can change the screen
+/// without further commits, keep capturing at the cap for a while. With no updates at
+/// all, a heartbeat capture keeps the stream alive.
+final class CaptureCoalescer {
+
+    struct Configuration {
+        var maximumFramesPerSecond: Double = 15
+        /// Longest gap between captures while nothing changes.
+        var heartbeatInterval: TimeInterval = 1
+        /// How long to keep capturing at the maximum rate after `noteActivity()`.
+        var activityHold: TimeInterval = 0.5
+    }
+
+    enum Trigger {
+        case update
+        case heartbeat
+    }
+
+    struct Counters {
+        var updates = 0
+        /// Updates folded into a capture that was already due.
+        var coalescedUpdates = 0
+        var updateCaptures = 0
+        var heartbeatCaptures = 0
+    }
+
+    let configuration: Configuration
+    let minimumInterval: UInt64
+    let heartbeatInterval: UInt64
+    private let holdDuration: UInt64
+    private let clock: MonotonicClock
+    private var lastCaptureTime: UInt64?
+    /// Time of the first update not yet captured.
+    private var pendingSince: UInt64?
+    private var activeUntil: UInt64?
+
+    private(set) var counters = Counters()
+
+    // MARK: - Init
+    init(configuration: Configuration = Configuration(), clock: MonotonicClock = SystemMonotonicClock.shared) {
+        precondition(configuration.maximumFramesPerSecond > 0, "maximumFramesPerSecond must be positive")
+        precondition(configuration.heartbeatInterval > 0, "heartbeatInterval must be positive")
+        self.configuration = configuration
+        self.clock = clock
+        minimumInterval = UInt64(1_000_000_000 / configuration.maximumFramesPerSecond)
+        heartbeatInterval = max(UInt64(configuration.heartbeatInterval * 1_000_000_000), minimumInterval)
+        holdDuration = UInt64(max(configuration.activityHold, 0) * 1_000_000_000)
+    }
+
+    /// Forgets capture history, so the next update is captured immediately.
+    func reset() {
+        lastCaptureTime = nil
+        pendingSince = nil
+        activeUntil = nil
+        counters = Counters()
+    }
+
+    // MARK: - Signals
+
+    /// Records a UI update. Returns the new capture deadline when this update moved it
+    /// earlier, or `nil` when a capture is already due no later.
+    @discardableResult
+    func noteUpdate() -> UInt64? {
+        counters.updates += 1
+        guard pendingSince == nil else {
+            counters.coalescedUpdates += 1
+            return nil
+        }
+        pendingSince = clock.nanoseconds
+        return deadline
+    }
+
+    /// Records a touch or animation: an update now, and every capture for `activityHold`
+    /// treated as having one pending.
+    @discardableResult
+    func noteActivity() -> UInt64? {
+        activeUntil = clock.nanoseconds + holdDuration
+        return noteUpdate()
+    }
+
+    /// When the next capture is due, in clock nanoseconds: the rate-capped time for a
+    /// pending update, otherwise the heartbeat.
+    var deadline: UInt64 {
+        guard let lastCaptureTime = lastCaptureTime else {
+            return pendingSince ?? clock.nanoseconds
+        }
+        if let pendingSince = pendingSince {
+            return max(pendingSince, lastCaptureTime + minimumInterval)
+        }
+        return lastCaptureTime + heartbeatInterval
+    }
+
+    var hasPendingUpdate: Bool {
+        return pendingSince != nil
+    }
+
+    /// Called when the capture timer fires. Returns why a capture should happen now and
+    /// records it, or `nil` if the deadline hasn't been reached (the timer fired early or
+    /// was armed for an older deadline).
+    func fire() -> Trigger? {
+        let now = clock.nanoseconds
+        guard now >= deadline else { return nil }
+        let trigger: Trigger = pendingSince != nil ? .update : .heartbeat
+        if trigger == .update {
+            counters.updateCaptures += 1
+        } else {
+            counters.heartbeatCaptures += 1
+        }
+        lastCaptureTime = now
+        if let activeUntil = activeUntil, now < activeUntil {
+            pendingSince = now
+        } else {
+            pendingSince = nil
+            activeUntil = nil
+        }
+        return trigger
+    }
+}
@@ -0,0 +1,27 @@
+import Foundation
+
+/// Output frame size for a captured view: the longer side scaled to `maximumDimension`,
+/// the other following the view's aspect ratio.
+struct CaptureGeometry: Equatable {
+    let outputWidth: Int
+    let outputHeight: Int
+    /// Output pixels per view point.
+    let outputScale: CGFloat
+
+    init(viewSize: CGSize, maximumDimension: CGFloat) {
+        precondition(viewSize.width > 0 && viewSize.height > 0, "view size must be positive")
+        let aspect = viewSize.width / viewSize.height
+        var container = CGSize.zero
+        if viewSize.width > viewSize.height {
+            container.width = maximumDimension
+            container.height = maximumDimension / aspect
+        } else {
+            container.height = maximumDimension
+            container.width = maximumDimension * aspect
+        }
+        // Even dimensions keep the 2x2-subsampled chroma planes exact.
+        outputWidth = Int((container.width / 2).rounded(.up)) * 2
+        outputHeight = Int((container.height / 2).rounded(.up)) * 2
+        outputScale = maximumDimension / max(viewSize.width, viewSize.height)
+    }
+}
@@ -0,0 +1,83 @@
+import Foundation
+
+/// Decides how long `ScreenCapturer` waits before the next capture. Runs at the maximum
+/// rate while the screen changes or the user interacts, then backs off exponentially
+/// towards the minimum rate once things go quiet.
+final class CaptureRateScheduler {
+
+    struct Configuration {
+        var minimumFramesPerSecond: Double = 1
+        var maximumFramesPerSecond: Double = 15
+        /// How long to stay at the maximum rate after the last activity.
+        var activityHold: TimeInterval = 0.5
+        var backoffMultiplier: Double = 2
+        /// Frames where a smaller fraction of tiles changed (a blinking caret, a clock
+        /// ticking) are sent but don't count as activity.
+        var minorChangeFraction: Double = 0.01
+    }
+
+    enum Activity {
+        case frameChanged
+        case touch
+        case animation
+    }
+
+    let configuration: Configuration
+    private let clock: MonotonicClock
+    private let minimumInterval: UInt64
+    private let maximumInterval: UInt64
+    private let holdDuration: UInt64
+    private var lastActivityTime: UInt64?
+
+    private(set) var lastActivity: Activity?
+    private(set) var currentInterval: UInt64
+
+    // MARK: - Init
+    init(configuration: Configuration = Configuration(), clock: MonotonicClock = SystemMonotonicClock.shared) {
+        precondition(configuration.minimumFramesPerSecond > 0, "minimumFramesPerSecond must be positive")
+        precondition(configuration.maximumFramesPerSecond >= configuration.minimumFramesPerSecond,
+                     "maximumFramesPerSecond must not be below minimumFramesPerSecond")
+        precondition(configuration.backoffMultiplier >= 1, "backoffMultiplier must be at least 1")
+        self.configuration = configuration
+        self.clock = clock
+        minimumInterval = UInt64(1_000_000_000 / configuration.maximumFramesPerSecond)
+        maximumInterval = UInt64(1_000_000_000 / configuration.minimumFramesPerSecond)
+        holdDuration = UInt64(configuration.activityHold * 1_000_000_000)
+        currentInterval = minimumInterval
+    }
+
+    var framesPerSecond: Double {
+        return 1_000_000_000 / Double(currentInterval)
+    }
+
+    // MARK: - Policy
+
+    /// Records activity and returns `true` when this shortened the interval, meaning a
+    /// capture already scheduled with the old interval should be brought forward.
+    @discardableResult
+    func noteActivity(_ activity: Activity) -> Bool {
+        lastActivity = activity
+        lastActivityTime = clock.nanoseconds
+        let shortened = currentInterval > minimumInterval
+        currentInterval = minimumInterval
+        return shortened
+    }
+
+    /// Feeds back the outcome of a capture and returns the delay, in nanoseconds, until
+    /// the next one.
+    func frameCaptured(changedTiles: Int, totalTiles: Int) -> UInt64 {
+        let fraction = totalTiles > 0 ? Double(changedTiles) / Double(totalTiles) : 0
+        if changedTiles > 0 && fraction >= configuration.minorChangeFraction {
+            noteActivity(.frameChanged)
+        } else if !isHoldingAfterActivity {
+            let backedOff = Double(currentInterval) * configuration.backoffMultiplier
+            currentInterval = min(UInt64(backedOff), maximumInterval)
+        }
+        return currentInterval
+    }
+
+    private var isHoldingAfterActivity: Bool {
+        guard let lastActivityTime = lastActivityTime else { return false }
+        return clock.nanoseconds - lastActivityTime < holdDuration
+    }
+}
@@ -0,0 +1,28 @@
+import Foundation
+
+/// Wall-clock time spent in each stage of one captured frame, in nanoseconds, plus the
+/// amount of pixel memory the frame's full-frame passes wrote.
+public struct CaptureStageTimings {
+    public var snapshot: UInt64 = 0
+    public var redaction: UInt64 = 0
+    public var resize: UInt64 = 0
+    public var conversion: UInt64 = 0
+    public var consume: UInt64 = 0
+    public var pixelBytesWritten = 0
+    /// Time the frame held the main thread. Overlaps `snapshot`, so it is not part of
+    /// `total`.
+    public var mainThread: UInt64 = 0
+
+    public init() {}
+
+    public var total: UInt64 {
+        return snapshot + redaction + resize + conversion + consume
+    }
+
+    /// Runs `body` and adds its duration to `stage`.
+    mutating func measure<T>(_ stage: WritableKeyPath<CaptureStageTimings, UInt64>, _ body: () throws -> T) rethrows -> T {
+        let start = DispatchTime.now().uptimeNanoseconds
+        defer { self[keyPath: stage] += DispatchTime.now().uptimeNanoseconds - start }
+        return try body()
+    }
+}
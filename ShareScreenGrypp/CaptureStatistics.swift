@@ -0,0 +1,103 @@
+import Foundation
+
+/// Per-stage latency histograms, in nanoseconds, and frame outcome counters for one
+/// capture session.
+public struct CaptureStatistics {
+    public internal(set) var snapshot = LatencyHistogram()
+    public internal(set) var redaction = LatencyHistogram()
+    /// Only frames that were downscaled.
+    public internal(set) var resize = LatencyHistogram()
+    public internal(set) var conversion = LatencyHistogram()
+    public internal(set) var consume = LatencyHistogram()
+    public internal(set) var mainThread = LatencyHistogram()
+
+    /// Frames handed to the video consumer.
+    public internal(set) var sentFrames = 0
+    /// Frames lost because no buffer was free or a newer raster replaced them in the queue.
+    public internal(set) var droppedFrames = 0
+    /// Frames not sent because nothing changed since the last one.
+    public internal(set) var skippedFrames = 0
+    /// Frames that could not be rasterized.
+    public internal(set) var failedFrames = 0
+
+    public init() {}
+}
+
+/// Collects `CaptureStatistics` on the capture queues. Recording only bumps counters in
+/// storage allocated up front; `snapshot()` copies out into fresh histograms, so the
+/// recorder's storage is never shared and recording never triggers a copy.
+final class CaptureStatisticsRecorder {
+
+    enum Outcome {
+        case sent
+        case dropped
+        case skipped
+        case failed
+    }
+
+    private var statistics = CaptureStatistics()
+    private let lock = NSLock()
+
+    // MARK: - Recording
+
+    /// Records every stage of `timings` that ran.
+    func record(_ timings: CaptureStageTimings) {
+        lock.lock()
+        defer { lock.unlock() }
+        if timings.snapshot > 0 { statistics.snapshot.record(timings.snapshot) }
+        if timings.redaction > 0 { statistics.redaction.record(timings.redaction) }
+        if timings.resize > 0 { statistics.resize.record(timings.resize) }
+        if timings.conversion > 0 { statistics.conversion.record(timings.conversion) }
+        if timings.consume > 0 { statistics.consume.record(timings.consume) }
+        if timings.mainThread > 0 { statistics.mainThread.record(timings.mainThread) }
+    }
+
+    func count(_ outcome: Outcome) {
+        lock.lock()
+        defer { lock.unlock() }
+        switch outcome {
+        case .sent:
+            statistics.sentFrames += 1
+        case .dropped:
+            statistics.droppedFrames += 1
+        case .skipped:
+            statistics.skippedFrames += 1
+        case .failed:
+            statistics.failedFrames += 1
+        }
+    }
+
+    func reset() {
+        lock.lock()
+        defer { lock.unlock() }
+        statistics.snapshot.reset()
+        statistics.redaction.reset()
+        statistics.resize.reset()
+        statistics.conversion.reset()
+        statistics.consume.reset()
+        statistics.mainThread.reset()
+        statistics.sentFrames = 0
+        statistics.droppedFrames = 0
+        statistics.skippedFrames = 0
+        statistics.failedFrames = 0
+    }
+
+    // MARK: - Reading
+
+    func snapshot() -> CaptureStatistics {
+        var copy = CaptureStatistics()
+        lock.lock()
+        defer { lock.unlock() }
+        copy.snapshot.merge(statistics.snapshot)
+        copy.redaction.merge(statistics.redaction)
+        copy.resize.merge(statistics.resize)
+        copy.conversion.merge(statistics.conversion)
+        copy.consume.merge(statistics.consume)
+        copy.mainThread.merge(statistics.mainThread)
+        copy.sentFrames = statistics.sentFrames
+        copy.droppedFrames = statistics.droppedFrames
+        copy.skippedFrames = statistics.skippedFrames
+        copy.failedFrames = statistics.failedFrames
+        return copy
+    }
+}
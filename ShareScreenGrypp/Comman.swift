@@ -2,56 +2,6 @@
 import Foundation
 import UIKit
 
-struct DrawEndSignal: Codable {
-    let action: String
-    let eventId: String
-    let order: Int
-    let totalChunks: Int
-    let value: String
-}
-
-struct FabricPathObject: Codable {
-    let stroke: String?
-    let strokeWidth: CGFloat?
-    let path: [[PathCommandValue]]
-}
-
-enum PathCommandValue: Codable {
-    case string(String)
-    case number(CGFloat)
-    
-    init(from decoder: Decoder) throws {
-        let container = try decoder.singleValueContainer()
-        if let str = try? container.decode(String.self) {
-            self = .string(str)
-        } else if let num = try? container.decode(CGFloat.self) {
-            self = .number(num)
-        } else {
-            throw DecodingError.typeMismatch(PathCommandValue.self, DecodingError.Context(codingPath: decoder.codingPath, debugDescription: "Invalid path value"))
-        }
-    }
-    
-    func encode(to encoder: Encoder) throws {
-        var container = encoder.singleValueContainer()
-        switch self {
-        case .string(let str): try container.encode(str)
-        case .number(let num): try container.encode(num)
-        }
-    }
-}
-
-func extractPoints(from path: [[PathCommandValue]]) -> [CGPoint] {
-    var points = [CGPoint]()
-    for segment in path {
-        guard segment.count >= 3 else { continue }
-        if case let .number(xVal) = segment[1],
-           case let .number(yVal) = segment[2] {
-            points.append(CGPoint(x: xVal, y: yVal))
-        }
-    }
-    return points
-}
-
 public protocol sessionConnectGryppDelegate: AnyObject { 
     func sessionConnectGryppSuccess(value: String)
     func sessionDisconnectGryppSuccess(value: String)
@@ -124,3 +74,22 @@ class DrawingView: UIView {
         }
     }
 }
+
+extension CGMutablePath {
+    func add(_ elements: [AnnotationPathElement]) {
+        for element in elements {
+            switch element {
+            case let .move(to):
+                move(to: to)
+            case let .line(to):
+                addLine(to: to)
+            case let .quadCurve(to, control):
+                addQuadCurve(to: to, control: control)
+            case let .curve(to, control1, control2):
+                addCurve(to: to, control1: control1, control2: control2)
+            case .closeSubpath:
+                closeSubpath()
+            }
+        }
+    }
+}
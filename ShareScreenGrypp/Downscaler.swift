@@ -0,0 +1,254 @@
+import Foundation
+
+/// Shrinks BGRA frames with a separable fixed-point filter. Weight tables and scratch rows
+/// are built once per geometry and reused, so repeated calls at the same size allocate
+/// nothing. An exact 2:1 box reduction, the common 3x-screen case, has a vectorized path.
+final class Downscaler {
+
+    enum Mode {
+        /// Output pixel `i` averages source pixels `floor(i * ratio)..<floor((i + 1) * ratio)`
+        /// with equal weights, so every source pixel is used once. At a non-integer ratio
+        /// the block widths alternate, e.g. between 1 and 2 pixels at 1170:592.
+        case box
+        /// Two-tap interpolation at each output pixel centre.
+        case bilinear
+        /// Weights every source pixel by how much of it the output pixel covers.
+        case areaAverage
+    }
+
+    let mode: Mode
+    let allowsFastPaths: Bool
+
+    // MARK: - Cached Geometry
+    private struct Geometry: Equatable {
+        let sourceWidth: Int
+        let sourceHeight: Int
+        let destinationWidth: Int
+        let destinationHeight: Int
+    }
+
+    /// Per output index: the first source index and its fixed-point weights.
+    private struct WeightTable {
+        var starts: [Int] = []
+        var offsets: [Int] = []
+        var weights: [Int32] = []
+
+        func count(at index: Int) -> Int {
+            return offsets[index + 1] - offsets[index]
+        }
+    }
+
+    private static let weightBits: Int32 = 12
+    private static let weightOne: Int32 = 1 << weightBits
+
+    private var geometry: Geometry?
+    private var horizontal = WeightTable()
+    private var vertical = WeightTable()
+    /// Source rows after the horizontal pass, one output-width row per source row.
+    private var scratch: [UInt8] = []
+    private var accumulator: [Int32] = []
+
+    // MARK: - Init
+    init(mode: Mode = .areaAverage, allowsFastPaths: Bool = true) {
+        self.mode = mode
+        self.allowsFastPaths = allowsFastPaths
+    }
+
+    // MARK: - Scaling
+
+    func scale(_ source: FrameBuffer, into destination: FrameBuffer) {
+        precondition(source.format == .bgra && destination.format == .bgra, "only BGRA frames can be scaled")
+        precondition(destination.width <= source.width && destination.height <= source.height, "only downscaling is supported")
+
+        if allowsFastPaths, mode != .bilinear,
+           source.width == destination.width * 2, source.height == destination.height * 2 {
+            Downscaler.halve(source, into: destination)
+            return
+        }
+
+        prepare(for: Geometry(sourceWidth: source.width, sourceHeight: source.height,
+                              destinationWidth: destination.width, destinationHeight: destination.height))
+        resampleHorizontally(source)
+        resampleVertically(into: destination)
+    }
+
+    private func prepare(for geometry: Geometry) {
+        guard geometry != self.geometry else { return }
+        self.geometry = geometry
+        horizontal = Downscaler.weights(mode: mode, from: geometry.sourceWidth, to: geometry.destinationWidth)
+        vertical = Downscaler.weights(mode: mode, from: geometry.sourceHeight, to: geometry.destinationHeight)
+        scratch = [UInt8](repeating: 0, count: geometry.destinationWidth * 4 * geometry.sourceHeight)
+        accumulator = [Int32](repeating: 0, count: geometry.destinationWidth * 4)
+    }
+
+    private func resampleHorizontally(_ source: FrameBuffer) {
+        let width = horizontal.starts.count
+        let rowBytes = width * 4
+        // Only rows some output row reads from.
+        let lastRow = vertical.starts[vertical.starts.count - 1] + vertical.count(at: vertical.starts.count - 1)
+        let table = horizontal
+        scratch.withUnsafeMutableBufferPointer { scratch in
+            for y in 0..<lastRow {
+                let input = UnsafeRawPointer(source.baseAddress() + y * source.bytesPerRow())
+                let output = scratch.baseAddress! + y * rowBytes
+                for x in 0..<width {
+                    var sum = SIMD4<Int32>(repeating: Downscaler.weightOne / 2)
+                    var column = table.starts[x]
+                    for tap in table.offsets[x]..<table.offsets[x + 1] {
+                        let pixel = input.loadUnaligned(fromByteOffset: column * 4, as: SIMD4<UInt8>.self)
+                        sum &+= SIMD4<Int32>(truncatingIfNeeded: pixel) &* table.weights[tap]
+                        column += 1
+                    }
+                    let value = SIMD4<UInt8>(truncatingIfNeeded: Downscaler.clamp(sum &>> Downscaler.weightBits))
+                    UnsafeMutableRawPointer(output).storeBytes(of: value, toByteOffset: x * 4, as: SIMD4<UInt8>.self)
+                }
+            }
+        }
+    }
+
+    private func resampleVertically(into destination: FrameBuffer) {
+        let rowBytes = horizontal.starts.count * 4
+        let table = vertical
+        scratch.withUnsafeBufferPointer { scratch in
+            accumulator.withUnsafeMutableBufferPointer { accumulator in
+                for y in 0..<destination.height {
+                    for i in 0..<rowBytes {
+                        accumulator[i] = Downscaler.weightOne / 2
+                    }
+                    var row = table.starts[y]
+                    for tap in table.offsets[y]..<table.offsets[y + 1] {
+                        let weight = table.weights[tap]
+                        let input = scratch.baseAddress! + row * rowBytes
+                        for i in 0..<rowBytes {
+                            accumulator[i] &+= Int32(input[i]) &* weight
+                        }
+                        row += 1
+                    }
+                    let output = (destination.baseAddress() + y * destination.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+                    for i in 0..<rowBytes {
+                        output[i] = UInt8(clamping: accumulator[i] >> Downscaler.weightBits)
+                    }
+                }
+            }
+        }
+    }
+
+    @inline(__always)
+    private static func clamp(_ value: SIMD4<Int32>) -> SIMD4<Int32> {
+        return value.clamped(lowerBound: SIMD4(repeating: 0), upperBound: SIMD4(repeating: 255))
+    }
+
+    // MARK: - 2:1 Box
+
+    /// Averages 2x2 blocks, eight output pixels per iteration. Each pixel's four 16-bit
+    /// channel sums are packed into one 64-bit lane, so horizontal neighbours are added
+    /// lane-wise without shuffling channels apart.
+    static func halve(_ source: FrameBuffer, into destination: FrameBuffer) {
+        let width = destination.width
+        for y in 0..<destination.height {
+            let top = UnsafeRawPointer(source.baseAddress() + 2 * y * source.bytesPerRow())
+            let bottom = UnsafeRawPointer(source.baseAddress() + (2 * y + 1) * source.bytesPerRow())
+            let output = destination.baseAddress() + y * destination.bytesPerRow()
+            var x = 0
+            while x + 8 <= width {
+                let upper = SIMD64<UInt16>(truncatingIfNeeded: top.loadUnaligned(fromByteOffset: x * 8, as: SIMD64<UInt8>.self))
+                let lower = SIMD64<UInt16>(truncatingIfNeeded: bottom.loadUnaligned(fromByteOffset: x * 8, as: SIMD64<UInt8>.self))
+                let pixels = unsafeBitCast(upper &+ lower, to: SIMD16<UInt64>.self)
+                let sums = pixels.evenHalf &+ pixels.oddHalf &+ 0x0002_0002_0002_0002
+                let averages = (sums &>> 2) & 0x00FF_00FF_00FF_00FF
+                let bytes = SIMD32<UInt8>(truncatingIfNeeded: unsafeBitCast(averages, to: SIMD32<UInt16>.self))
+                output.storeBytes(of: bytes, toByteOffset: x * 4, as: SIMD32<UInt8>.self)
+                x += 8
+            }
+            let t = top.assumingMemoryBound(to: UInt8.self)
+            let b = bottom.assumingMemoryBound(to: UInt8.self)
+            let o = output.assumingMemoryBound(to: UInt8.self)
+            while x < width {
+                for c in 0..<4 {
+                    let i = x * 8 + c
+                    let sum = Int(t[i]) + Int(t[i + 4]) + Int(b[i]) + Int(b[i + 4])
+                    o[x * 4 + c] = UInt8((sum + 2) >> 2)
+                }
+                x += 1
+            }
+        }
+    }
+
+    // MARK: - Weight Tables
+
+    private static func weights(mode: Mode, from sourceCount: Int, to destinationCount: Int) -> WeightTable {
+        var table = WeightTable()
+        table.starts.reserveCapacity(destinationCount)
+        table.offsets.reserveCapacity(destinationCount + 1)
+        table.offsets.append(0)
+        let ratio = Double(sourceCount) / Double(destinationCount)
+
+        for i in 0..<destinationCount {
+            var taps: [(index: Int, weight: Double)] = []
+            switch mode {
+            case .box:
+                // Downscaling keeps every block at least one pixel wide.
+                let begin = i * sourceCount / destinationCount
+                let end = (i + 1) * sourceCount / destinationCount
+                taps = (begin..<end).map { (index: $0, weight: 1.0) }
+            case .bilinear:
+                let center = (Double(i) + 0.5) * ratio - 0.5
+                let first = min(max(Int(center.rounded(.down)), 0), sourceCount - 1)
+                let fraction = min(max(center - Double(first), 0), 1)
+                taps = [(first, 1 - fraction)]
+                if first + 1 < sourceCount {
+                    taps.append((first + 1, fraction))
+                }
+            case .areaAverage:
+                let begin = Double(i) * ratio
+                let end = Double(i + 1) * ratio
+                var index = Int(begin.rounded(.down))
+                while Double(index) < end && index < sourceCount {
+                    let overlap = min(end, Double(index + 1)) - max(begin, Double(index))
+                    if overlap > 1e-9 {
+                        taps.append((index, overlap))
+                    }
+                    index += 1
+                }
+            }
+            append(taps, to: &table)
+        }
+        return table
+    }
+
+    /// Quantizes the taps so they sum to exactly `weightOne`, which keeps flat colours
+    /// exact through both passes.
+    private static func append(_ taps: [(index: Int, weight: Double)], to table: inout WeightTable) {
+        let total = taps.reduce(0) { $0 + $1.weight }
+        var quantized = taps.map { Int32(($0.weight / total * Double(weightOne)).rounded()) }
+        let error = weightOne - quantized.reduce(0, +)
+        if let largest = quantized.indices.max(by: { quantized[$0] < quantized[$1] }) {
+            quantized[largest] += error
+        }
+        table.starts.append(taps.first?.index ?? 0)
+        table.weights.append(contentsOf: quantized)
+        table.offsets.append(table.weights.count)
+    }
+
+    // MARK: - Quality
+
+    /// Peak signal-to-noise ratio over the colour channels of two equally sized frames, in
+    /// dB. Identical frames return `.infinity`.
+    static func psnr(_ lhs: FrameBuffer, _ rhs: FrameBuffer) -> Double {
+        precondition(lhs.width == rhs.width && lhs.height == rhs.height, "frames differ in size")
+        var squaredError = 0.0
+        for y in 0..<lhs.height {
+            let a = (lhs.baseAddress() + y * lhs.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+            let b = (rhs.baseAddress() + y * rhs.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+            for x in 0..<lhs.width {
+                for c in 0..<3 {
+                    let diff = Double(a[x * 4 + c]) - Double(b[x * 4 + c])
+                    squaredError += diff * diff
+                }
+            }
+        }
+        guard squaredError > 0 else { return .infinity }
+        let meanSquaredError = squaredError / Double(lhs.width * lhs.height * 3)
+        return 10 * log10(255 * 255 / meanSquaredError)
+    }
+}
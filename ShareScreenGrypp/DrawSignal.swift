@@ -0,0 +1,347 @@
+import Foundation
+
+struct DrawEndSignal: Codable {
+    let action: String
+    let eventId: String
+    let order: Int
+    let totalChunks: Int
+    let value: String
+}
+
+struct FabricPathObject: Codable {
+    let stroke: String?
+    let strokeWidth: CGFloat?
+    let path: [[PathCommandValue]]
+}
+
+enum PathCommandValue: Codable {
+    case string(String)
+    case number(CGFloat)
+    
+    init(from decoder: Decoder) throws {
+        let container = try decoder.singleValueContainer()
+        if let str = try? container.decode(String.self) {
+            self = .string(str)
+        } else if let num = try? container.decode(CGFloat.self) {
+            self = .number(num)
+        } else {
+            throw DecodingError.typeMismatch(PathCommandValue.self, DecodingError.Context(codingPath: decoder.codingPath, debugDescription: "Invalid path value"))
+        }
+    }
+    
+    func encode(to encoder: Encoder) throws {
+        var container = encoder.singleValueContainer()
+        switch self {
+        case .string(let str): try container.encode(str)
+        case .number(let num): try container.encode(num)
+        }
+    }
+}
+
+func extractPoints(from path: [[PathCommandValue]]) -> [CGPoint] {
+    var points = [CGPoint]()
+    for segment in path {
+        guard segment.count >= 3 else { continue }
+        if case let .number(xVal) = segment[1],
+           case let .number(yVal) = segment[2] {
+            points.append(CGPoint(x: xVal, y: yVal))
+        }
+    }
+    return points
+}
+
+extension FabricPathObject {
+    /// Decodes a path from the joined base64 payload of a draw event.
+    static func decode(fromBase64 payload: String) -> FabricPathObject? {
+        guard let data = Data(base64Encoded: payload) else { return nil }
+        return try? JSONDecoder().decode(FabricPathObject.self, from: data)
+    }
+}
+
+// MARK: - Chunk Reassembly
+
+/// What one chunk added to a streamed draw event.
+struct DrawStreamUpdate {
+    let eventId: String
+    /// Path commands completed by this chunk, in path order.
+    let commands: [[PathCommandValue]]
+    let stroke: String?
+    let strokeWidth: CGFloat?
+    let isComplete: Bool
+    /// When the event's first chunk arrived, on the assembler's clock.
+    let firstChunkTime: UInt64
+}
+
+/// Collects the chunks of each draw event and returns the joined payload once all of
+/// them have arrived. Each event gets a slot per chunk, sized by its `totalChunks`, so a
+/// chunk lands by `order` and a repeated one is dropped instead of counting toward
+/// completion. Completed events are remembered for `timeToLive`, so a late copy of one of
+/// their chunks is dropped as a duplicate too rather than starting the event over. Events
+/// that never complete (a lost chunk) expire after `timeToLive`, and the oldest pending
+/// events are evicted when their payloads and slots exceed `maximumPendingBytes`.
+/// `append(_:)` streams instead: chunks are decoded as soon as the ordered prefix
+/// reaches them.
+final class DrawChunkAssembler {
+
+    struct Configuration {
+        /// How long an event may wait for its missing chunks, from its first chunk.
+        var timeToLive: TimeInterval = 10
+        /// Cap on the bytes held across all pending events: their chunks and their slots.
+        var maximumPendingBytes = 4 * 1024 * 1024
+        /// Larger `totalChunks` values are rejected rather than allocated.
+        var maximumChunksPerEvent = 4096
+    }
+
+    struct Counters {
+        var completed = 0
+        /// Chunks whose slot was already filled, or whose event completed within
+        /// `timeToLive`.
+        var duplicates = 0
+        /// Chunks with an out-of-range order or chunk count, or a chunk count that
+        /// disagrees with earlier chunks of the same event.
+        var rejected = 0
+        /// Events dropped incomplete after `timeToLive`.
+        var expired = 0
+        /// Events dropped incomplete to stay under `maximumPendingBytes`.
+        var evicted = 0
+    }
+
+    private struct PendingEvent {
+        var slots: [String?]
+        var received = 0
+        /// Held chunk bytes plus the slots themselves.
+        var bytes: Int
+        let firstSeen: UInt64
+        /// Chunks before this have been fed to `decoder` by `append(_:)`.
+        var delivered = 0
+        var decoder: DrawStreamDecoder?
+
+        init(totalChunks: Int, firstSeen: UInt64) {
+            slots = [String?](repeating: nil, count: totalChunks)
+            bytes = DrawChunkAssembler.slotBytes(totalChunks: totalChunks)
+            self.firstSeen = firstSeen
+        }
+    }
+
+    let configuration: Configuration
+    private let timeToLive: UInt64
+    private let clock: MonotonicClock
+    private var events: [String: PendingEvent] = [:]
+    /// Event ids by first-seen time, oldest first, for expiry and eviction. Entries of
+    /// events that already completed are skipped when reached.
+    private var arrivals: [(eventId: String, firstSeen: UInt64)] = []
+    private var arrivalsHead = 0
+    /// Completion times of recently completed events, and their ids in completion order.
+    private var completedAt: [String: UInt64] = [:]
+    private var completions: [(eventId: String, completedAt: UInt64)] = []
+    private var completionsHead = 0
+
+    private(set) var pendingBytes = 0
+    private(set) var counters = Counters()
+
+    var pendingEventCount: Int {
+        return events.count
+    }
+
+    func isPending(_ eventId: String) -> Bool {
+        return events[eventId] != nil
+    }
+
+    /// What an event's slots count against `maximumPendingBytes`.
+    static func slotBytes(totalChunks: Int) -> Int {
+        return totalChunks * MemoryLayout<String?>.stride
+    }
+
+    // MARK: - Init
+    init(configuration: Configuration = Configuration(), clock: MonotonicClock = SystemMonotonicClock.shared) {
+        precondition(configuration.timeToLive > 0, "timeToLive must be positive")
+        precondition(configuration.maximumChunksPerEvent > 0, "maximumChunksPerEvent must be positive")
+        self.configuration = configuration
+        self.clock = clock
+        timeToLive = UInt64(configuration.timeToLive * 1_000_000_000)
+    }
+
+    // MARK: - Insertion
+
+    /// Adds `signal` and returns its event's payload, in chunk order, if it completed it.
+    func insert(_ signal: DrawEndSignal) -> String? {
+        guard let event = place(signal) else { return nil }
+        guard event.received == event.slots.count else {
+            keep(event, for: signal.eventId)
+            return nil
+        }
+        complete(event, for: signal.eventId)
+        var payload = ""
+        payload.reserveCapacity(event.bytes - DrawChunkAssembler.slotBytes(totalChunks: event.slots.count))
+        for case let chunk? in event.slots {
+            payload += chunk
+        }
+        return payload
+    }
+
+    /// Adds `signal` and feeds any chunks that now extend its event's contiguous prefix
+    /// to the event's `DrawStreamDecoder`, releasing them. Returns the path commands that
+    /// completed, or nil if the prefix didn't grow. Don't mix with `insert(_:)` for the
+    /// same event.
+    func append(_ signal: DrawEndSignal) -> DrawStreamUpdate? {
+        guard var event = place(signal) else { return nil }
+        guard event.slots[event.delivered] != nil else {
+            keep(event, for: signal.eventId)
+            return nil
+        }
+        let decoder = event.decoder ?? DrawStreamDecoder()
+        event.decoder = decoder
+        var commands: [[PathCommandValue]] = []
+        while event.delivered < event.slots.count, let chunk = event.slots[event.delivered] {
+            commands += decoder.feed(chunk)
+            let bytes = chunk.utf8.count
+            // An empty slot still counts as filled for duplicate checks.
+            event.slots[event.delivered] = ""
+            event.bytes -= bytes
+            pendingBytes -= bytes
+            event.delivered += 1
+        }
+        let isComplete = event.delivered == event.slots.count
+        if isComplete {
+            complete(event, for: signal.eventId)
+        } else {
+            keep(event, for: signal.eventId)
+        }
+        return DrawStreamUpdate(eventId: signal.eventId, commands: commands, stroke: decoder.stroke,
+                                strokeWidth: decoder.strokeWidth, isComplete: isComplete,
+                                firstChunkTime: event.firstSeen)
+    }
+
+    /// Stores `signal` in its event's slot and returns the event, taken out of `events`,
+    /// or nil if the chunk was rejected or a duplicate.
+    private func place(_ signal: DrawEndSignal) -> PendingEvent? {
+        let now = clock.nanoseconds
+        evictExpired(now: now)
+
+        let totalChunks = signal.totalChunks
+        guard totalChunks > 0, totalChunks <= configuration.maximumChunksPerEvent,
+              signal.order >= 0, signal.order < totalChunks else {
+            counters.rejected += 1
+            return nil
+        }
+        let eventId = signal.eventId
+        guard completedAt[eventId] == nil else {
+            counters.duplicates += 1
+            return nil
+        }
+        var event: PendingEvent
+        if let pending = events.removeValue(forKey: eventId) {
+            event = pending
+        } else {
+            event = PendingEvent(totalChunks: totalChunks, firstSeen: now)
+            pendingBytes += event.bytes
+            arrivals.append((eventId, now))
+        }
+        guard event.slots.count == totalChunks else {
+            counters.rejected += 1
+            events[eventId] = event
+            return nil
+        }
+        guard event.slots[signal.order] == nil else {
+            counters.duplicates += 1
+            events[eventId] = event
+            return nil
+        }
+
+        let bytes = signal.value.utf8.count
+        event.slots[signal.order] = signal.value
+        event.received += 1
+        event.bytes += bytes
+        pendingBytes += bytes
+        return event
+    }
+
+    /// Releases a completed event and remembers its id for `timeToLive`.
+    private func complete(_ event: PendingEvent, for eventId: String) {
+        pendingBytes -= event.bytes
+        counters.completed += 1
+        let now = clock.nanoseconds
+        completedAt[eventId] = now
+        completions.append((eventId, now))
+    }
+
+    /// Puts an incomplete event back and evicts the oldest events while over the cap.
+    private func keep(_ event: PendingEvent, for eventId: String) {
+        events[eventId] = event
+        while pendingBytes > configuration.maximumPendingBytes, let oldest = popOldest() {
+            pendingBytes -= oldest.bytes
+            counters.evicted += 1
+        }
+    }
+
+    // MARK: - Expiry
+
+    /// Drops incomplete events older than `timeToLive`. `insert(_:)` does this itself;
+    /// call it to release memory while no chunks are arriving.
+    func evictExpired() {
+        evictExpired(now: clock.nanoseconds)
+    }
+
+    private func evictExpired(now: UInt64) {
+        while completionsHead < completions.count {
+            let completion = completions[completionsHead]
+            guard now &- completion.completedAt >= timeToLive else { break }
+            if completedAt[completion.eventId] == completion.completedAt {
+                completedAt.removeValue(forKey: completion.eventId)
+            }
+            completionsHead += 1
+        }
+        while arrivalsHead < arrivals.count {
+            let arrival = arrivals[arrivalsHead]
+            guard let event = events[arrival.eventId], event.firstSeen == arrival.firstSeen else {
+                arrivalsHead += 1
+                continue
+            }
+            guard now &- event.firstSeen >= timeToLive else { break }
+            events.removeValue(forKey: arrival.eventId)
+            arrivalsHead += 1
+            pendingBytes -= event.bytes
+            counters.expired += 1
+        }
+        compactArrivalsIfNeeded()
+    }
+
+    /// Removes and returns the pending event seen first.
+    private func popOldest() -> PendingEvent? {
+        while arrivalsHead < arrivals.count {
+            let arrival = arrivals[arrivalsHead]
+            arrivalsHead += 1
+            if let event = events[arrival.eventId], event.firstSeen == arrival.firstSeen {
+                events.removeValue(forKey: arrival.eventId)
+                return event
+            }
+        }
+        return nil
+    }
+
+    private func compactArrivalsIfNeeded() {
+        DrawChunkAssembler.compact(&arrivals, head: &arrivalsHead)
+        DrawChunkAssembler.compact(&completions, head: &completionsHead)
+    }
+
+    /// Drops the consumed front of a FIFO once it is empty or mostly consumed.
+    private static func compact<Element>(_ queue: inout [Element], head: inout Int) {
+        if head == queue.count {
+            queue.removeAll(keepingCapacity: true)
+            head = 0
+        } else if head >= 1024, head * 2 >= queue.count {
+            queue.removeFirst(head)
+            head = 0
+        }
+    }
+
+    func removeAll() {
+        events.removeAll()
+        arrivals.removeAll()
+        arrivalsHead = 0
+        completedAt.removeAll()
+        completions.removeAll()
+        completionsHead = 0
+        pendingBytes = 0
+    }
+}
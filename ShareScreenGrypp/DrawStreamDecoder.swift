@@ -0,0 +1,216 @@
+import Foundation
+
+/// Decodes a draw event's base64 Fabric path payload as its chunks arrive in order and
+/// returns each path command as soon as its bytes are complete, so a stroke can be drawn
+/// before the whole payload is in. Only the top-level `stroke`, `strokeWidth` and `path`
+/// members are parsed; everything else is skipped without being decoded.
+final class DrawStreamDecoder {
+
+    private(set) var stroke: String?
+    private(set) var strokeWidth: CGFloat?
+    private(set) var commandCount = 0
+    /// The closing brace of the top-level object has been read.
+    private(set) var isFinished = false
+    /// The payload isn't valid base64 or isn't shaped like a path object. Later input is
+    /// ignored.
+    private(set) var hasFailed = false
+
+    // Base64 state: up to three sextets of an incomplete quad.
+    private var quad: UInt32 = 0
+    private var quadLength = 0
+    private var isPadded = false
+
+    // JSON state. `bytes` holds decoded input from the oldest token still needed.
+    private var bytes: [UInt8] = []
+    private var position = 0
+    private var depth = 0
+    private var inString = false
+    private var escaped = false
+    private var expectingKey = false
+    private var key: String?
+    private var keyStart: Int?
+    private var valueStart: Int?
+    private var commandStart: Int?
+
+    private static let base64Values: [UInt8] = {
+        var values = [UInt8](repeating: 0xFF, count: 256)
+        for (index, character) in "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/".utf8.enumerated() {
+            values[Int(character)] = UInt8(index)
+        }
+        return values
+    }()
+
+    /// Decodes the next chunk of the payload and returns the path commands it completed.
+    func feed(_ chunk: String) -> [[PathCommandValue]] {
+        guard !hasFailed, !isFinished else { return [] }
+        bytes.reserveCapacity(bytes.count + chunk.utf8.count * 3 / 4)
+        for character in chunk.utf8 {
+            if character == UInt8(ascii: "=") {
+                flushPadding()
+                continue
+            }
+            let value = DrawStreamDecoder.base64Values[Int(character)]
+            guard value != 0xFF, !isPadded else {
+                hasFailed = true
+                return []
+            }
+            quad = quad << 6 | UInt32(value)
+            quadLength += 1
+            if quadLength == 4 {
+                bytes.append(UInt8(truncatingIfNeeded: quad >> 16))
+                bytes.append(UInt8(truncatingIfNeeded: quad >> 8))
+                bytes.append(UInt8(truncatingIfNeeded: quad))
+                quad = 0
+                quadLength = 0
+            }
+        }
+        guard !hasFailed else { return [] }
+        return scan()
+    }
+
+    /// The first `=` ends the data; the bits of a partial quad give one or two bytes.
+    private func flushPadding() {
+        guard !isPadded else { return }
+        isPadded = true
+        switch quadLength {
+        case 0:
+            break
+        case 2:
+            bytes.append(UInt8(truncatingIfNeeded: quad >> 4))
+        case 3:
+            bytes.append(UInt8(truncatingIfNeeded: quad >> 10))
+            bytes.append(UInt8(truncatingIfNeeded: quad >> 2))
+        default:
+            hasFailed = true
+        }
+        quad = 0
+        quadLength = 0
+    }
+
+    // MARK: - JSON
+
+    private static let quote = UInt8(ascii: "\"")
+    private static let backslash = UInt8(ascii: "\\")
+
+    private var wantsValue: Bool {
+        return key == "stroke" || key == "strokeWidth"
+    }
+
+    private func scan() -> [[PathCommandValue]] {
+        var commands: [[PathCommandValue]] = []
+        while position < bytes.count, !hasFailed, !isFinished {
+            let byte = bytes[position]
+            if inString {
+                if escaped {
+                    escaped = false
+                } else if byte == DrawStreamDecoder.backslash {
+                    escaped = true
+                } else if byte == DrawStreamDecoder.quote {
+                    inString = false
+                    if let start = keyStart {
+                        key = String(decoding: bytes[(start + 1)..<position], as: UTF8.self)
+                        keyStart = nil
+                    }
+                }
+                position += 1
+                continue
+            }
+            switch byte {
+            case DrawStreamDecoder.quote:
+                inString = true
+                if depth == 1 && expectingKey {
+                    keyStart = position
+                } else {
+                    markValueStart()
+                }
+            case UInt8(ascii: "{"), UInt8(ascii: "["):
+                markValueStart()
+                depth += 1
+                if depth == 1 {
+                    expectingKey = byte == UInt8(ascii: "{")
+                    if !expectingKey { hasFailed = true }
+                } else if depth == 3 && key == "path" {
+                    commandStart = position
+                }
+            case UInt8(ascii: "}"), UInt8(ascii: "]"):
+                if depth == 3, let start = commandStart {
+                    commandStart = nil
+                    if let command = parseCommand(bytes[(start + 1)..<position]) {
+                        commands.append(command)
+                    } else {
+                        hasFailed = true
+                    }
+                }
+                depth -= 1
+                if depth == 0 {
+                    finishValue(end: position)
+                    isFinished = true
+                } else if depth < 0 {
+                    hasFailed = true
+                }
+            case UInt8(ascii: ","):
+                if depth == 1 {
+                    finishValue(end: position)
+                    expectingKey = true
+                }
+            case UInt8(ascii: ":"):
+                if depth == 1 {
+                    expectingKey = false
+                }
+            case UInt8(ascii: " "), UInt8(ascii: "\n"), UInt8(ascii: "\r"), UInt8(ascii: "\t"):
+                break
+            default:
+                markValueStart()
+            }
+            position += 1
+        }
+        commandCount += commands.count
+        compact()
+        return hasFailed ? [] : commands
+    }
+
+    private func markValueStart() {
+        if depth == 1 && !expectingKey && valueStart == nil && wantsValue {
+            valueStart = position
+        }
+    }
+
+    private func finishValue(end: Int) {
+        guard let start = valueStart else { return }
+        valueStart = nil
+        let text = String(decoding: bytes[start..<end], as: UTF8.self).trimmingCharacters(in: .whitespaces)
+        if key == "stroke" {
+            stroke = text.count >= 2 && text.hasPrefix("\"") ? String(text.dropFirst().dropLast()) : nil
+        } else if let width = Double(text) {
+            strokeWidth = CGFloat(width)
+        }
+    }
+
+    /// Parses the inside of `["Q",1,2,3,4]`: a quoted command letter, then numbers.
+    private func parseCommand(_ body: ArraySlice<UInt8>) -> [PathCommandValue]? {
+        var command: [PathCommandValue] = []
+        for element in body.split(separator: UInt8(ascii: ","), omittingEmptySubsequences: false) {
+            let text = String(decoding: element, as: UTF8.self).trimmingCharacters(in: .whitespaces)
+            if text.hasPrefix("\"") {
+                guard text.count >= 2, text.hasSuffix("\"") else { return nil }
+                command.append(.string(String(text.dropFirst().dropLast())))
+            } else if let number = Double(text) {
+                command.append(.number(CGFloat(number)))
+            } else {
+                return nil
+            }
+        }
+        return command
+    }
+
+    /// Drops decoded bytes no pending key, value or command still points into.
+    private func compact() {
+        let keep = min(position, keyStart ?? .max, valueStart ?? .max, commandStart ?? .max)
+        guard keep > 0 else { return }
+        bytes.removeFirst(keep)
+        position -= keep
+        keyStart = keyStart.map { $0 - keep }
+        valueStart = valueStart.map { $0 - keep }
+        commandStart = commandStart.map { $0 - keep }
+    }
+}
@@ -0,0 +1,194 @@
+import Foundation
+
+enum FramePixelFormat: Hashable {
+    /// 32-bit little-endian ARGB, i.e. B, G, R, A in memory. What OpenTok calls `.ARGB`.
+    case bgra
+    /// 8-bit luma plane followed by an interleaved, 2x2-subsampled CbCr plane.
+    case nv12
+    /// 8-bit luma plane followed by separate 2x2-subsampled Cb and Cr planes.
+    case i420
+
+    struct PlaneLayout {
+        let width: Int
+        let height: Int
+        let bytesPerPixel: Int
+    }
+
+    func planeLayouts(width: Int, height: Int) -> [PlaneLayout] {
+        switch self {
+        case .bgra:
+            return [PlaneLayout(width: width, height: height, bytesPerPixel: 4)]
+        case .nv12:
+            return [PlaneLayout(width: width, height: height, bytesPerPixel: 1),
+                    PlaneLayout(width: (width + 1) / 2, height: (height + 1) / 2, bytesPerPixel: 2)]
+        case .i420:
+            return [PlaneLayout(width: width, height: height, bytesPerPixel: 1),
+                    PlaneLayout(width: (width + 1) / 2, height: (height + 1) / 2, bytesPerPixel: 1),
+                    PlaneLayout(width: (width + 1) / 2, height: (height + 1) / 2, bytesPerPixel: 1)]
+        }
+    }
+}
+
+struct FrameBufferKey: Hashable {
+    let width: Int
+    let height: Int
+    let format: FramePixelFormat
+}
+
+/// A preallocated, stride-aligned frame owned by a `FrameBufferPool`. All planes live in
+/// one allocation; rows start on `FrameBufferPool.alignment` byte boundaries.
+final class FrameBuffer {
+
+    struct Plane {
+        let offset: Int
+        let width: Int
+        let height: Int
+        let bytesPerRow: Int
+    }
+
+    let key: FrameBufferKey
+    let planes: [Plane]
+    let byteCount: Int
+    let data: UnsafeMutableRawPointer
+    /// State the lessee builds for this buffer once and reuses on later leases, such as a
+    /// drawing context over `data`.
+    var attachment: AnyObject?
+    fileprivate var isLeased = false
+
+    fileprivate init(key: FrameBufferKey, alignment: Int) {
+        self.key = key
+        var planes: [Plane] = []
+        var offset = 0
+        for layout in key.format.planeLayouts(width: key.width, height: key.height) {
+            let bytesPerRow = (layout.width * layout.bytesPerPixel + alignment - 1) / alignment * alignment
+            planes.append(Plane(offset: offset, width: layout.width, height: layout.height, bytesPerRow: bytesPerRow))
+            offset += bytesPerRow * layout.height
+        }
+        self.planes = planes
+        byteCount = max(offset, alignment)
+        data = UnsafeMutableRawPointer.allocate(byteCount: byteCount, alignment: alignment)
+    }
+
+    deinit {
+        data.deallocate()
+    }
+
+    var width: Int { key.width }
+    var height: Int { key.height }
+    var format: FramePixelFormat { key.format }
+
+    func baseAddress(ofPlane index: Int = 0) -> UnsafeMutableRawPointer {
+        return data + planes[index].offset
+    }
+
+    func bytesPerRow(ofPlane index: Int = 0) -> Int {
+        return planes[index].bytesPerRow
+    }
+}
+
+/// Fixed-size rings of reusable frame buffers, one ring per dimensions/format pair.
+/// Frames are leased for the duration of a capture and handed back with `recycle(_:)`;
+/// once a ring is warm, steady-state capture allocates nothing.
+final class FrameBufferPool {
+
+    struct Counters {
+        /// Buffers created, including whole rings allocated for a new key.
+        var allocations = 0
+        var leases = 0
+        var recycles = 0
+        /// Leases refused because every buffer of the ring was still out.
+        var exhaustions = 0
+    }
+
+    static let alignment = 64
+
+    let capacity: Int
+    let maximumRetainedKeys: Int
+
+    private final class Ring {
+        let buffers: [FrameBuffer]
+        var cursor = 0
+        var leasedCount = 0
+        var lastUse = 0
+
+        init(buffers: [FrameBuffer]) {
+            self.buffers = buffers
+        }
+    }
+
+    private let lock = NSLock()
+    private var rings: [FrameBufferKey: Ring] = [:]
+    private var useCounter = 0
+    private var _counters = Counters()
+
+    // MARK: - Init
+    init(capacity: Int = 3, maximumRetainedKeys: Int = 2) {
+        precondition(capacity > 0, "capacity must be positive")
+        precondition(maximumRetainedKeys > 0, "maximumRetainedKeys must be positive")
+        self.capacity = capacity
+        self.maximumRetainedKeys = maximumRetainedKeys
+    }
+
+    var counters: Counters {
+        lock.lock()
+        defer { lock.unlock() }
+        return _counters
+    }
+
+    // MARK: - Lease/Recycle
+
+    /// Returns a free buffer for the given geometry, or `nil` when the ring is exhausted and
+    /// the caller should drop the frame.
+    func lease(width: Int, height: Int, format: FramePixelFormat = .bgra) -> FrameBuffer? {
+        precondition(width > 0 && height > 0, "frame dimensions must be positive")
+        let key = FrameBufferKey(width: width, height: height, format: format)
+        lock.lock()
+        defer { lock.unlock() }
+
+        let ring: Ring
+        if let existing = rings[key] {
+            ring = existing
+        } else {
+            evictIdleRings()
+            ring = Ring(buffers: (0..<capacity).map { _ in FrameBuffer(key: key, alignment: FrameBufferPool.alignment) })
+            rings[key] = ring
+            _counters.allocations += capacity
+        }
+        useCounter += 1
+        ring.lastUse = useCounter
+
+        for step in 0..<capacity {
+            let index = (ring.cursor + step) % capacity
+            let buffer = ring.buffers[index]
+            if !buffer.isLeased {
+                buffer.isLeased = true
+                ring.cursor = (index + 1) % capacity
+                ring.leasedCount += 1
+                _counters.leases += 1
+                return buffer
+            }
+        }
+        _counters.exhaustions += 1
+        return nil
+    }
+
+    func recycle(_ buffer: FrameBuffer) {
+        lock.lock()
+        defer { lock.unlock() }
+        precondition(buffer.isLeased, "buffer recycled twice")
+        buffer.isLeased = false
+        _counters.recycles += 1
+        // Rings are only evicted with nothing leased, so this is the buffer's own ring.
+        rings[buffer.key]?.leasedCount -= 1
+    }
+
+    /// Drops the least recently used rings with nothing leased once the key limit is hit,
+    /// e.g. the portrait ring after a rotation has settled.
+    private func evictIdleRings() {
+        while rings.count >= maximumRetainedKeys {
+            guard let victim = rings.filter({ $0.value.leasedCount == 0 })
+                    .min(by: { $0.value.lastUse < $1.value.lastUse })?.key else { return }
+            rings.removeValue(forKey: victim)
+        }
+    }
+}
@@ -0,0 +1,112 @@
+import Foundation
+
+/// Stamps captured frames with presentation times for the encoder.
+///
+/// Capture ticks wander by a few milliseconds around the scheduled interval (main-thread
+/// latency, timer slack). Passing that wander on makes the encoder's rate control see an
+/// uneven frame rate, so presentation times are snapped to whole multiples of the nominal
+/// interval measured from the previous frame. Each snap moves a frame by at most half an
+/// interval and is re-anchored to real elapsed time every frame, so the stream never
+/// drifts from the wall clock.
+///
+/// Presentation times never go backwards: a stream that is stopped and started again
+/// keeps its time base, so the pause shows up as a gap rather than a restart at zero.
+final class FrameClock {
+
+    struct Stamp {
+        /// Monotonic time the frame was captured.
+        let captureTime: UInt64
+        /// Nanoseconds since the first frame, paced.
+        let presentationTime: UInt64
+
+        /// `presentationTime` expressed in ticks of `timescale` per second.
+        func presentationTicks(timescale: Int64) -> Int64 {
+            let seconds = presentationTime / 1_000_000_000
+            let remainder = presentationTime % 1_000_000_000
+            return Int64(seconds) * timescale + Int64(remainder) * timescale / 1_000_000_000
+        }
+    }
+
+    struct Statistics {
+        /// Time between consecutive captures.
+        var frameIntervals = LatencyHistogram()
+        /// How far each capture interval was from the interval it was scheduled for.
+        var jitter = LatencyHistogram()
+    }
+
+    /// Smallest step between presentation times when a capture comes early.
+    static let minimumStep: UInt64 = 1_000_000
+
+    private let clock: MonotonicClock
+    private let lock = NSLock()
+    private var startTime: UInt64?
+    private var lastCaptureTime: UInt64 = 0
+    private var lastPresentationTime: UInt64 = 0
+    /// Set by `resume()`: the next frame follows a pause and isn't paced.
+    private var isResuming = false
+    private var _statistics = Statistics()
+
+    // MARK: - Init
+    init(clock: MonotonicClock = SystemMonotonicClock.shared) {
+        self.clock = clock
+    }
+
+    var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return Statistics(frameIntervals: _statistics.frameIntervals.detachedCopy(),
+                          jitter: _statistics.jitter.detachedCopy())
+    }
+
+    /// Continues the stream after capture was stopped: the next frame is presented at
+    /// its real time since the first frame, and statistics start over.
+    func resume() {
+        lock.lock()
+        defer { lock.unlock() }
+        isResuming = startTime != nil
+        _statistics = Statistics()
+    }
+
+    // MARK: - Stamping
+
+    /// Stamps a frame captured now, `nominalInterval` nanoseconds after the previous
+    /// capture was scheduled to repeat.
+    func stamp(nominalInterval: UInt64) -> Stamp {
+        let now = clock.nanoseconds
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard let startTime = startTime else {
+            self.startTime = now
+            lastCaptureTime = now
+            lastPresentationTime = 0
+            return Stamp(captureTime: now, presentationTime: 0)
+        }
+
+        let elapsed = now - startTime
+        if isResuming {
+            // The pause isn't a capture interval; present the frame at real time.
+            isResuming = false
+            lastCaptureTime = now
+            lastPresentationTime = max(elapsed, lastPresentationTime + FrameClock.minimumStep)
+            return Stamp(captureTime: now, presentationTime: lastPresentationTime)
+        }
+
+        let interval = now - lastCaptureTime
+        _statistics.frameIntervals.record(interval)
+        _statistics.jitter.record(interval > nominalInterval ? interval - nominalInterval : nominalInterval - interval)
+
+        var presentation = elapsed
+        if nominalInterval > 0, elapsed > lastPresentationTime {
+            let steps = (elapsed - lastPresentationTime + nominalInterval / 2) / nominalInterval
+            if steps > 0 {
+                presentation = lastPresentationTime + steps * nominalInterval
+            }
+        }
+        presentation = max(presentation, lastPresentationTime + FrameClock.minimumStep)
+
+        lastCaptureTime = now
+        lastPresentationTime = presentation
+        return Stamp(captureTime: now, presentationTime: presentation)
+    }
+}
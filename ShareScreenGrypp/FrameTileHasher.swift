@@ -0,0 +1,111 @@
+import Foundation
+
+/// Detects which parts of a 32-bit frame changed since the previous call by hashing it
+/// in fixed-size square tiles. `ScreenCapturer` uses it to stop re-sending static screens.
+final class FrameTileHasher {
+
+    struct Report {
+        let changedTiles: Int
+        let totalTiles: Int
+
+        var isDirty: Bool { changedTiles > 0 }
+    }
+
+    let tileSize: Int
+
+    // MARK: - Tile State
+    private var tileHashes: [UInt64] = []
+    private var rowHashes: [UInt64] = []
+    private var width = 0
+    private var height = 0
+    private var columns = 0
+    private var rows = 0
+    private var hasPreviousFrame = false
+
+    // MARK: - Init
+    init(tileSize: Int = 32) {
+        precondition(tileSize > 0, "tileSize must be positive")
+        self.tileSize = tileSize
+    }
+
+    /// Forgets the previous frame so the next `update` reports every tile as changed.
+    func reset() {
+        hasPreviousFrame = false
+    }
+
+    // MARK: - Hashing
+
+    func update(baseAddress: UnsafeRawPointer, width: Int, height: Int, bytesPerRow: Int) -> Report {
+        guard width > 0, height > 0 else { return Report(changedTiles: 0, totalTiles: 0) }
+        if width != self.width || height != self.height {
+            self.width = width
+            self.height = height
+            columns = (width + tileSize - 1) / tileSize
+            rows = (height + tileSize - 1) / tileSize
+            tileHashes = [UInt64](repeating: 0, count: columns * rows)
+            rowHashes = [UInt64](repeating: 0, count: columns)
+            hasPreviousFrame = false
+        }
+
+        let columns = self.columns
+        let rows = self.rows
+        let tileSize = self.tileSize
+        let tileBytes = tileSize * 4
+        let rowBytes = width * 4
+        let forceDirty = !hasPreviousFrame
+        var changed = 0
+
+        tileHashes.withUnsafeMutableBufferPointer { stored in
+            rowHashes.withUnsafeMutableBufferPointer { current in
+                for tileRow in 0..<rows {
+                    for column in 0..<columns {
+                        current[column] = FrameTileHasher.seed
+                    }
+                    // Walk whole scanlines so memory is read sequentially, feeding each
+                    // tile-wide span into the accumulator of the tile it belongs to.
+                    let firstLine = tileRow * tileSize
+                    let lastLine = min(firstLine + tileSize, height)
+                    for y in firstLine..<lastLine {
+                        let line = baseAddress + y * bytesPerRow
+                        var offset = 0
+                        for column in 0..<columns {
+                            let end = min(offset + tileBytes, rowBytes)
+                            current[column] = FrameTileHasher.hash(line, from: offset, to: end, into: current[column])
+                            offset = end
+                        }
+                    }
+                    let base = tileRow * columns
+                    for column in 0..<columns where forceDirty || stored[base + column] != current[column] {
+                        stored[base + column] = current[column]
+                        changed += 1
+                    }
+                }
+            }
+        }
+
+        hasPreviousFrame = true
+        return Report(changedTiles: changed, totalTiles: columns * rows)
+    }
+
+    private static let seed: UInt64 = 0xCBF2_9CE4_8422_2325
+
+    @inline(__always)
+    private static func hash(_ line: UnsafeRawPointer, from start: Int, to end: Int, into state: UInt64) -> UInt64 {
+        var h = state
+        var offset = start
+        while offset + 8 <= end {
+            h = mix(h, line.loadUnaligned(fromByteOffset: offset, as: UInt64.self))
+            offset += 8
+        }
+        if offset < end {
+            h = mix(h, UInt64(line.loadUnaligned(fromByteOffset: offset, as: UInt32.self)))
+        }
+        return h
+    }
+
+    @inline(__always)
+    private static func mix(_ h: UInt64, _ word: UInt64) -> UInt64 {
+        let x = h ^ (word &* 0x9E37_79B9_7F4A_7C15)
+        return ((x << 27) | (x >> 37)) &* 0x0000_0100_0000_01B3
+    }
+}
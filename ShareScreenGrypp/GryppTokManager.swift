@@ -12,6 +12,7 @@ public class GryppTokManager: NSObject {
     // MARK: - OpenTok Properties
     private var session: OTSession?
     private var capturer: ScreenCapturer?
+    private let sensitiveViews = SensitiveViewRegistry<UIView>()
     private var publisher: OTPublisher?
     private var gryppSession: GryppSession?
 
@@ -23,18 +24,20 @@ public class GryppTokManager: NSObject {
     private let localCursorDotView = UIView()
     private let localNameLabel = UILabel()
     private var customPopupView: CustomPopupView?
-    private var isLocalCursorScheduledForRemoval = false
 
     // MARK: - Observers
     private var backgroundObserver: NSObjectProtocol?
     private var foregroundObserver: NSObjectProtocol?
 
-    // MARK: - Drawing
-    private var drawChunks: [String: [DrawEndSignal]] = [:]
+    // MARK: - Timers & Drawing
+    private let timers = SessionTimers<SessionTimer>()
+    private let drawChunks = DrawChunkAssembler()
+    private lazy var annotations = AnnotationOverlay(timers: timers)
 
     // MARK: - Init/Deinit
     private override init() {
         super.init()
+        annotations.incompleteLifetime = drawChunks.configuration.timeToLive
         setupAppStateObservers()
         if let view = GryppTokManager.appWindow?.topMostView() {
                 let touchView = TouchCaptureView(frame: view.bounds)
@@ -60,6 +63,38 @@ public class GryppTokManager: NSObject {
         shared.showEndSessionPopup()
     }
 
+    /// Call when the host app starts an animation so the screen share keeps up with it.
+    public static func noteAnimationActivity() {
+        shared.capturer?.noteActivity(.animation)
+    }
+
+    /// Redacts `view` from the screen share until it is unmarked or deallocated.
+    /// Call on the main thread.
+    public static func markSensitive(_ view: UIView) {
+        shared.sensitiveViews.mark(view)
+    }
+
+    public static func unmarkSensitive(_ view: UIView) {
+        shared.sensitiveViews.unmark(view)
+    }
+
+    /// Call on the main thread after changing what `redactionPolicy` rules look at on
+    /// views already on screen, such as an accessibility identifier, so the share picks
+    /// it up. Added and removed views are noticed without it.
+    public static func sensitiveContentDidChange() {
+        shared.capturer?.setNeedsSensitiveRescan()
+    }
+
+    /// Time from the first chunk of an agent's stroke arriving to the stroke's first
+    /// segment going on screen.
+    public static var annotationLatency: LatencyHistogram {
+        return shared.annotations.statistics.firstPixelLatency
+    }
+
+    public static var annotationStatistics: AnnotationStatistics {
+        return shared.annotations.statistics
+    }
+
     public static func setUpDraggableButton(view: UIWindow, frame: CGRect) -> DraggableButton {
         let button = DraggableButton(frame: frame)
         view.addSubview(button)
@@ -234,7 +269,8 @@ public class GryppTokManager: NSObject {
         publisher?.videoType = .screen
         publisher?.audioFallbackEnabled = false
         
-        capturer = ScreenCapturer(captureViewProvider: { appWindow.topMostView() ?? UIView() })
+        capturer = ScreenCapturer(captureViewProvider: { appWindow.topMostView() ?? UIView() },
+                                  sensitiveViews: sensitiveViews)
           
         publisher?.videoCapture = capturer
         publisher?.videoCapture?.videoContentHint = UIDevice.current.userInterfaceIdiom == .pad ? .motion : .text
@@ -275,15 +311,8 @@ public class GryppTokManager: NSObject {
 
     private func updateLocalCursor(to point: CGPoint, agentName: String) {
         updateCursor(view: localCursorView, label: localNameLabel, dot: localCursorDotView, point: point, name: agentName, color: .green)
-        if !isLocalCursorScheduledForRemoval {
-            isLocalCursorScheduledForRemoval = true
-            DispatchQueue.main.asyncAfter(deadline: .now() + 5.0) { [weak self] in
-                guard let self = self else { return }
-                if self.localCursorView.superview != nil {
-                    self.localCursorView.removeFromSuperview()
-                }
-                self.isLocalCursorScheduledForRemoval = false
-            }
+        timers.schedule(.localCursor, after: 5.0, rearm: .keepEarlier) { [weak self] in
+            self?.localCursorView.removeFromSuperview()
         }
     }
 
@@ -330,7 +359,8 @@ public class GryppTokManager: NSObject {
     }
 
     func handleTouch(at point: CGPoint, event: String) {
-        print("Touch point: \(point)")
+        Logger.touch.trace("Touch point: \(point) (\(event))")
+        capturer?.noteActivity(.touch)
         updateLocalCursor(to: point, agentName: "Local User")
     }
 
@@ -397,32 +427,6 @@ public class GryppTokManager: NSObject {
         return []
     }
     
-    func drawPath(from points: [CGPoint], stroke: String, strokeWidth: CGFloat) {
-        guard let window = GryppTokManager.appWindow, !points.isEmpty else { return }
-        
-        let path = UIBezierPath()
-        path.move(to: points[0])
-        
-        for point in points.dropFirst() {
-            path.addLine(to: point)
-        }
-        
-        let shapeLayer = CAShapeLayer()
-        shapeLayer.name = "grypp"
-        shapeLayer.path = path.cgPath
-        shapeLayer.strokeColor = UIColor(hex: stroke).cgColor
-        shapeLayer.fillColor = UIColor.clear.cgColor
-        shapeLayer.lineWidth = strokeWidth
-        
-        DispatchQueue.main.async {
-            window.layer.addSublayer(shapeLayer)
-            
-            DispatchQueue.main.asyncAfter(deadline: .now() + 5.0) {
-                shapeLayer.removeFromSuperlayer()
-            }
-        }
-    }
-
     // MARK: - Signal Handlers
 
     private func handleCodeRequested(_ json: [String: Any]) {
@@ -443,21 +447,9 @@ public class GryppTokManager: NSObject {
         guard let value = json["value"] as? String,
               let drawData = value.data(using: .utf8),
               let drawSignal = try? JSONDecoder().decode(DrawEndSignal.self, from: drawData) else { return }
-        let eventId = drawSignal.eventId
-        var chunks = drawChunks[eventId] ?? []
-        chunks.append(drawSignal)
-        drawChunks[eventId] = chunks
-        if chunks.count == drawSignal.totalChunks {
-            let base64Combined = chunks
-                .sorted(by: { $0.order < $1.order })
-                .map { $0.value }
-                .joined()
-            guard let decodedData = Data(base64Encoded: base64Combined),
-                  let pathObject = try? JSONDecoder().decode(FabricPathObject.self, from: decodedData) else { return }
-            let points = extractPoints(from: pathObject.path)
-            drawPath(from: points, stroke: pathObject.stroke ?? "#ff7a00", strokeWidth: pathObject.strokeWidth ?? 5.0)
-            drawChunks.removeValue(forKey: eventId)
-        }
+        guard let update = drawChunks.append(drawSignal),
+              let window = GryppTokManager.appWindow else { return }
+        annotations.apply(update, in: window)
     }
 
     // MARK: - Cleanup
@@ -468,6 +460,9 @@ public class GryppTokManager: NSObject {
         capturer?.releaseCapture()
         capturer = nil
         publisher = nil
+        drawChunks.removeAll()
+        annotations.removeAll()
+        timers.cancelAll()
         GryppTokManager.appWindow?.layer.sublayers?
             .filter { $0.name == "grypp" }
             .forEach { $0.removeFromSuperlayer() }
@@ -518,16 +513,16 @@ extension GryppTokManager: OTSessionDelegate, OTPublisherDelegate {
     public func session(_ session: OTSession, receivedSignalType type: String?, from connection: OTConnection?, with data: String?) {
         guard let data = data?.data(using: .utf8),
               let json = (try? JSONSerialization.jsonObject(with: data)) as? [String: Any] else {
-            print("Signal JSON parsing error")
+            Logger.signal.warning("Signal JSON parsing error")
             return
         }
         
-        print("📩 Signal type: \(type ?? "nil")")
-        print("📦 Signal data: \(json)")
+        Logger.signal.debug("📩 Signal type: \(type ?? "nil")")
+        Logger.signal.trace("📦 Signal data: \(json)")
         if (type == "screenshare_ping") {
             if self.agentCursorView.superview != nil {
-                DispatchQueue.main.asyncAfter(deadline: .now() + 5.0) {
-                    self.agentCursorView.removeFromSuperview()
+                timers.schedule(.agentCursor, after: 5.0, rearm: .keepEarlier) { [weak self] in
+                    self?.agentCursorView.removeFromSuperview()
                 }
             }
         }
@@ -542,7 +537,7 @@ extension GryppTokManager: OTSessionDelegate, OTPublisherDelegate {
             handleDraw(json)
         default:
            
-            print("⚠️ Unhandled action: \(action)")
+            Logger.signal.warning("⚠️ Unhandled action: \(action)")
         }
     }
 
@@ -0,0 +1,105 @@
+import Foundation
+
+/// Log-linear histogram of nanosecond durations in the style of HdrHistogram: values below
+/// 32 ns get their own bucket, larger ones land in one of 16 sub-buckets per power of two,
+/// so any recorded value is known to within about 6%. Storage is allocated once at init
+/// and `record(_:)` never allocates.
+public struct LatencyHistogram {
+
+    static let subBucketBits = 4
+    static let subBucketCount = 1 << subBucketBits
+    static let bucketCount = (64 - subBucketBits + 1) * subBucketCount
+
+    private var counts: [UInt64]
+    public private(set) var count: UInt64 = 0
+    public private(set) var minimum: UInt64 = .max
+    public private(set) var maximum: UInt64 = 0
+    private var sum: Double = 0
+
+    public init() {
+        counts = [UInt64](repeating: 0, count: LatencyHistogram.bucketCount)
+    }
+
+    // MARK: - Recording
+
+    mutating func record(_ value: UInt64) {
+        counts[LatencyHistogram.bucketIndex(of: value)] += 1
+        count += 1
+        minimum = Swift.min(minimum, value)
+        maximum = Swift.max(maximum, value)
+        sum += Double(value)
+    }
+
+    mutating func reset() {
+        for index in counts.indices {
+            counts[index] = 0
+        }
+        count = 0
+        minimum = .max
+        maximum = 0
+        sum = 0
+    }
+
+    mutating func merge(_ other: LatencyHistogram) {
+        guard other.count > 0 else { return }
+        for index in counts.indices {
+            counts[index] += other.counts[index]
+        }
+        count += other.count
+        minimum = Swift.min(minimum, other.minimum)
+        maximum = Swift.max(maximum, other.maximum)
+        sum += other.sum
+    }
+
+    /// A copy with its own bucket storage. Hand these out from a histogram that keeps
+    /// recording: a plain copy shares storage, so the next `record(_:)` would copy every
+    /// bucket, possibly while holding the recorder's lock.
+    func detachedCopy() -> LatencyHistogram {
+        var copy = LatencyHistogram()
+        copy.merge(self)
+        return copy
+    }
+
+    // MARK: - Queries
+
+    public var mean: Double {
+        return count > 0 ? sum / Double(count) : 0
+    }
+
+    /// Smallest bucket bound at or below which `percentile` percent of the recorded values
+    /// fall, clamped to the recorded range. Returns 0 when empty.
+    public func value(atPercentile percentile: Double) -> UInt64 {
+        guard count > 0 else { return 0 }
+        guard percentile > 0 else { return minimum }
+        let rank = Swift.max(1, UInt64((Swift.min(Swift.max(percentile, 0), 100) / 100 * Double(count)).rounded(.up)))
+        var seen: UInt64 = 0
+        for index in counts.indices where counts[index] > 0 {
+            seen += counts[index]
+            if seen >= rank {
+                return Swift.min(Swift.max(LatencyHistogram.upperBound(ofBucket: index), minimum), maximum)
+            }
+        }
+        return maximum
+    }
+
+    // MARK: - Buckets
+
+    static func bucketIndex(of value: UInt64) -> Int {
+        let highestBit = 63 - value.leadingZeroBitCount
+        let exponent = Swift.max(0, highestBit - subBucketBits)
+        let mantissa = Int(value >> UInt64(exponent))
+        return exponent == 0 ? mantissa : exponent * subBucketCount + mantissa
+    }
+
+    static func lowerBound(ofBucket index: Int) -> UInt64 {
+        guard index >= 2 * subBucketCount else { return UInt64(index) }
+        let exponent = index / subBucketCount - 1
+        let mantissa = index - exponent * subBucketCount
+        return UInt64(mantissa) << UInt64(exponent)
+    }
+
+    static func upperBound(ofBucket index: Int) -> UInt64 {
+        guard index + 1 < bucketCount else { return .max }
+        return lowerBound(ofBucket: index + 1) - 1
+    }
+}
@@ -0,0 +1,236 @@
+import Foundation
+#if canImport(Darwin)
+import Darwin
+#else
+import Glibc
+#endif
+
+enum LogLevel: Int, Comparable {
+    case trace
+    case debug
+    case info
+    case warning
+    case error
+
+    static func < (lhs: LogLevel, rhs: LogLevel) -> Bool {
+        return lhs.rawValue < rhs.rawValue
+    }
+}
+
+struct LogRecord {
+    let level: LogLevel
+    let category: StaticString
+    /// On `SystemMonotonicClock`.
+    let timestamp: UInt64
+    let message: String
+
+    var formatted: String {
+        let milliseconds = timestamp / 1_000_000
+        return "[grypp \(milliseconds / 1000).\(String(milliseconds % 1000 + 1000).dropFirst())] \(level) \(category): \(message)"
+    }
+}
+
+/// Leveled logging for hot paths. Calls below `Logger.compiledLevel` compile to nothing,
+/// message included, once inlined; calls below `LogCenter.shared.minimumLevel` cost a
+/// comparison and never build their message. Enabled messages go into a ring buffer
+/// owned by the calling thread and are written out on a background queue, so logging
+/// never waits on stdout.
+struct Logger {
+    let category: StaticString
+
+    /// The lowest level that is compiled in: `.debug` in debug builds, `.info` in
+    /// release builds, and `.trace` with the `GRYPP_LOG_TRACE` compilation condition.
+    @inline(__always)
+    static var compiledLevel: LogLevel {
+        #if GRYPP_LOG_TRACE
+        return .trace
+        #elseif DEBUG
+        return .debug
+        #else
+        return .info
+        #endif
+    }
+
+    @inline(__always)
+    func trace(_ message: @autoclosure () -> String) {
+        log(.trace, message())
+    }
+
+    @inline(__always)
+    func debug(_ message: @autoclosure () -> String) {
+        log(.debug, message())
+    }
+
+    @inline(__always)
+    func info(_ message: @autoclosure () -> String) {
+        log(.info, message())
+    }
+
+    @inline(__always)
+    func warning(_ message: @autoclosure () -> String) {
+        log(.warning, message())
+    }
+
+    @inline(__always)
+    func error(_ message: @autoclosure () -> String) {
+        log(.error, message())
+    }
+
+    @inline(__always)
+    func log(_ level: LogLevel, _ message: @autoclosure () -> String) {
+        guard level >= Logger.compiledLevel, level >= LogCenter.shared.minimumLevel else { return }
+        LogCenter.shared.append(level: level, category: category, message: message())
+    }
+}
+
+extension Logger {
+    static let touch = Logger(category: "touch")
+    static let signal = Logger(category: "signal")
+    static let capture = Logger(category: "capture")
+}
+
+// MARK: - Buffering
+
+/// Per-thread ring buffers of log records and the queue that drains them. Each ring has
+/// its own lock, which only its thread and the drain ever take, so threads logging at
+/// the same time don't contend. A full ring overwrites its oldest records and the drain
+/// reports how many were lost.
+final class LogCenter {
+
+    static let shared = LogCenter()
+
+    /// Records below this level are discarded without building their message. Set it
+    /// before logging starts; it isn't synchronized.
+    var minimumLevel: LogLevel = .trace
+    /// Receives drained records on the drain queue, oldest first per thread.
+    var sink: (LogRecord) -> Void = { print($0.formatted) }
+
+    let ringCapacity: Int
+    private let drainQueue = DispatchQueue(label: "com.grypp.log", qos: .utility)
+    private var rings: [LogRing] = []
+    private let ringsLock = NSLock()
+    private var threadKey = pthread_key_t()
+
+    // MARK: - Init
+    init(ringCapacity: Int = 512) {
+        precondition(ringCapacity > 0, "ringCapacity must be positive")
+        self.ringCapacity = ringCapacity
+        #if canImport(Darwin)
+        pthread_key_create(&threadKey) { pointer in
+            Unmanaged<LogRing>.fromOpaque(pointer).takeRetainedValue().threadDidExit()
+        }
+        #else
+        pthread_key_create(&threadKey) { pointer in
+            guard let pointer = pointer else { return }
+            Unmanaged<LogRing>.fromOpaque(pointer).takeRetainedValue().threadDidExit()
+        }
+        #endif
+    }
+
+    func append(level: LogLevel, category: StaticString, message: String) {
+        let record = LogRecord(level: level, category: category, timestamp: SystemMonotonicClock.shared.nanoseconds,
+                               message: message)
+        if currentRing().append(record) {
+            drainQueue.async { self.drain() }
+        }
+    }
+
+    /// Waits until everything logged so far, from any thread, has reached the sink.
+    func flush() {
+        drainQueue.sync { drain() }
+    }
+
+    private func currentRing() -> LogRing {
+        if let pointer = pthread_getspecific(threadKey) {
+            return Unmanaged<LogRing>.fromOpaque(pointer).takeUnretainedValue()
+        }
+        let ring = LogRing(capacity: ringCapacity)
+        pthread_setspecific(threadKey, Unmanaged.passRetained(ring).toOpaque())
+        ringsLock.lock()
+        rings.append(ring)
+        ringsLock.unlock()
+        return ring
+    }
+
+    /// Runs on `drainQueue`.
+    private func drain() {
+        ringsLock.lock()
+        let current = rings
+        ringsLock.unlock()
+        var finished: [ObjectIdentifier] = []
+        for ring in current {
+            let (records, dropped, isFinished) = ring.takeAll()
+            if dropped > 0 {
+                sink(LogRecord(level: .warning, category: "log", timestamp: records.first?.timestamp ?? 0,
+                               message: "\(dropped) records dropped"))
+            }
+            records.forEach(sink)
+            if isFinished {
+                finished.append(ObjectIdentifier(ring))
+            }
+        }
+        guard !finished.isEmpty else { return }
+        ringsLock.lock()
+        rings.removeAll { finished.contains(ObjectIdentifier($0)) }
+        ringsLock.unlock()
+    }
+}
+
+/// One thread's pending records.
+private final class LogRing {
+    private var records: [LogRecord?]
+    private var head = 0
+    private var count = 0
+    private var dropped = 0
+    private var isDrainScheduled = false
+    private var hasThreadExited = false
+    private let lock = NSLock()
+
+    init(capacity: Int) {
+        records = [LogRecord?](repeating: nil, count: capacity)
+    }
+
+    /// Stores `record`, overwriting the oldest when full. Returns true if a drain needs
+    /// scheduling.
+    func append(_ record: LogRecord) -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        if count == records.count {
+            records[head] = record
+            head = (head + 1) % records.count
+            dropped += 1
+        } else {
+            records[(head + count) % records.count] = record
+            count += 1
+        }
+        guard !isDrainScheduled else { return false }
+        isDrainScheduled = true
+        return true
+    }
+
+    func takeAll() -> (records: [LogRecord], dropped: Int, isFinished: Bool) {
+        lock.lock()
+        defer { lock.unlock() }
+        var taken: [LogRecord] = []
+        taken.reserveCapacity(count)
+        for offset in 0..<count {
+            let index = (head + offset) % records.count
+            if let record = records[index] {
+                taken.append(record)
+            }
+            records[index] = nil
+        }
+        let lost = dropped
+        head = 0
+        count = 0
+        dropped = 0
+        isDrainScheduled = false
+        return (taken, lost, hasThreadExited)
+    }
+
+    func threadDidExit() {
+        lock.lock()
+        hasThreadExited = true
+        lock.unlock()
+    }
+}
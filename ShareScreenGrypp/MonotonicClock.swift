@@ -0,0 +1,32 @@
+import Foundation
+
+/// Source of monotonic time in nanoseconds. Timing-sensitive capture components take one
+/// so their policies can be driven deterministically in tests and benchmarks.
+protocol MonotonicClock: AnyObject {
+    var nanoseconds: UInt64 { get }
+}
+
+final class SystemMonotonicClock: MonotonicClock {
+    static let shared = SystemMonotonicClock()
+
+    var nanoseconds: UInt64 {
+        return DispatchTime.now().uptimeNanoseconds
+    }
+}
+
+/// Clock that only moves when told to.
+final class ManualClock: MonotonicClock {
+    private(set) var nanoseconds: UInt64
+
+    init(nanoseconds: UInt64 = 0) {
+        self.nanoseconds = nanoseconds
+    }
+
+    func advance(by nanoseconds: UInt64) {
+        self.nanoseconds += nanoseconds
+    }
+
+    func advance(milliseconds: Double) {
+        advance(by: UInt64(milliseconds * 1_000_000))
+    }
+}
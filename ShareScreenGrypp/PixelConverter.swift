@@ -0,0 +1,190 @@
+import Foundation
+
+/// Fixed-point RGB to video-range YCbCr coefficients, scaled by 256.
+struct YCbCrMatrix {
+    let yr: Int32, yg: Int32, yb: Int32
+    let ur: Int32, ug: Int32, ub: Int32
+    let vr: Int32, vg: Int32, vb: Int32
+
+    static let bt601 = YCbCrMatrix(yr: 66, yg: 129, yb: 25,
+                                   ur: -38, ug: -74, ub: 112,
+                                   vr: 112, vg: -94, vb: -18)
+
+    static let bt709 = YCbCrMatrix(yr: 47, yg: 157, yb: 16,
+                                   ur: -26, ug: -86, ub: 112,
+                                   vr: 112, vg: -102, vb: -10)
+}
+
+/// Converts BGRA frames to NV12 or I420 so OpenTok can hand them to the encoder without
+/// its own conversion pass. Chroma is the 2x2 average. The vectorized kernel uses Swift
+/// SIMD types, which lower to NEON on device and SSE/AVX on x86, and produces exactly the
+/// same bytes as the scalar reference.
+enum PixelConverter {
+
+    enum Implementation {
+        case scalar
+        case vectorized
+    }
+
+    static func convert(_ source: FrameBuffer,
+                        into destination: FrameBuffer,
+                        matrix: YCbCrMatrix = .bt601,
+                        implementation: Implementation = .vectorized) {
+        precondition(source.format == .bgra, "source must be BGRA")
+        precondition(source.width == destination.width && source.height == destination.height,
+                     "source and destination dimensions differ")
+
+        let u: UnsafeMutableRawPointer
+        let v: UnsafeMutableRawPointer
+        let uBytesPerRow: Int
+        let vBytesPerRow: Int
+        let chromaStep: Int
+        switch destination.format {
+        case .nv12:
+            u = destination.baseAddress(ofPlane: 1)
+            v = u + 1
+            uBytesPerRow = destination.bytesPerRow(ofPlane: 1)
+            vBytesPerRow = uBytesPerRow
+            chromaStep = 2
+        case .i420:
+            u = destination.baseAddress(ofPlane: 1)
+            v = destination.baseAddress(ofPlane: 2)
+            uBytesPerRow = destination.bytesPerRow(ofPlane: 1)
+            vBytesPerRow = destination.bytesPerRow(ofPlane: 2)
+            chromaStep = 1
+        case .bgra:
+            preconditionFailure("destination must be a YCbCr format")
+        }
+
+        let width = source.width
+        let height = source.height
+        let bgra = source.baseAddress()
+        let bgraBytesPerRow = source.bytesPerRow()
+        let luma = destination.baseAddress(ofPlane: 0)
+        let lumaBytesPerRow = destination.bytesPerRow(ofPlane: 0)
+
+        for pair in 0..<(height + 1) / 2 {
+            let y0 = pair * 2
+            let y1 = min(y0 + 1, height - 1)
+            let rows = RowPair(
+                source0: UnsafeRawPointer(bgra + y0 * bgraBytesPerRow),
+                source1: UnsafeRawPointer(bgra + y1 * bgraBytesPerRow),
+                luma0: luma + y0 * lumaBytesPerRow,
+                luma1: luma + y1 * lumaBytesPerRow,
+                u: u + pair * uBytesPerRow,
+                v: v + pair * vBytesPerRow,
+                chromaStep: chromaStep
+            )
+            var x = 0
+            if implementation == .vectorized {
+                x = convertVectorized(rows, width: width, matrix: matrix)
+            }
+            convertScalar(rows, from: x, width: width, matrix: matrix)
+        }
+    }
+
+    // MARK: - Kernels
+
+    private struct RowPair {
+        let source0: UnsafeRawPointer
+        let source1: UnsafeRawPointer
+        let luma0: UnsafeMutableRawPointer
+        let luma1: UnsafeMutableRawPointer
+        let u: UnsafeMutableRawPointer
+        let v: UnsafeMutableRawPointer
+        let chromaStep: Int
+    }
+
+    /// Reference implementation; also handles the columns the vector loop leaves over and
+    /// odd widths (the last column is paired with itself).
+    private static func convertScalar(_ rows: RowPair, from startX: Int, width: Int, matrix m: YCbCrMatrix) {
+        let s0 = rows.source0.assumingMemoryBound(to: UInt8.self)
+        let s1 = rows.source1.assumingMemoryBound(to: UInt8.self)
+        let l0 = rows.luma0.assumingMemoryBound(to: UInt8.self)
+        let l1 = rows.luma1.assumingMemoryBound(to: UInt8.self)
+        let u = rows.u.assumingMemoryBound(to: UInt8.self)
+        let v = rows.v.assumingMemoryBound(to: UInt8.self)
+
+        var x = startX
+        while x < width {
+            var sumR: Int32 = 0
+            var sumG: Int32 = 0
+            var sumB: Int32 = 0
+            for step in 0..<2 {
+                let column = min(x + step, width - 1)
+                let i = column * 4
+                let b0 = Int32(s0[i]), g0 = Int32(s0[i + 1]), r0 = Int32(s0[i + 2])
+                let b1 = Int32(s1[i]), g1 = Int32(s1[i + 1]), r1 = Int32(s1[i + 2])
+                l0[column] = UInt8(truncatingIfNeeded: ((m.yr * r0 + m.yg * g0 + m.yb * b0 + 128) >> 8) + 16)
+                l1[column] = UInt8(truncatingIfNeeded: ((m.yr * r1 + m.yg * g1 + m.yb * b1 + 128) >> 8) + 16)
+                sumR += r0 + r1
+                sumG += g0 + g1
+                sumB += b0 + b1
+            }
+            let c = (x / 2) * rows.chromaStep
+            u[c] = UInt8(truncatingIfNeeded: ((m.ur * sumR + m.ug * sumG + m.ub * sumB + 512) >> 10) + 128)
+            v[c] = UInt8(truncatingIfNeeded: ((m.vr * sumR + m.vg * sumG + m.vb * sumB + 512) >> 10) + 128)
+            x += 2
+        }
+    }
+
+    /// Converts 16 pixels of both rows per iteration and returns the first column it did
+    /// not handle.
+    private static func convertVectorized(_ rows: RowPair, width: Int, matrix m: YCbCrMatrix) -> Int {
+        var x = 0
+        while x + 16 <= width {
+            let (b0, g0, r0) = deinterleave(rows.source0.loadUnaligned(fromByteOffset: x * 4, as: SIMD64<UInt8>.self))
+            let (b1, g1, r1) = deinterleave(rows.source1.loadUnaligned(fromByteOffset: x * 4, as: SIMD64<UInt8>.self))
+            rows.luma0.storeBytes(of: luma(b0, g0, r0, m), toByteOffset: x, as: SIMD16<UInt8>.self)
+            rows.luma1.storeBytes(of: luma(b1, g1, r1, m), toByteOffset: x, as: SIMD16<UInt8>.self)
+
+            let sumB = pairSum(b0, b1)
+            let sumG = pairSum(g0, g1)
+            let sumR = pairSum(r0, r1)
+            let u = chroma(sumR, sumG, sumB, m.ur, m.ug, m.ub)
+            let v = chroma(sumR, sumG, sumB, m.vr, m.vg, m.vb)
+            if rows.chromaStep == 2 {
+                // Little-endian: each 16-bit lane stores Cb then Cr.
+                let cb = SIMD8<UInt16>(truncatingIfNeeded: u)
+                let cr = SIMD8<UInt16>(truncatingIfNeeded: v) &<< 8
+                rows.u.storeBytes(of: cb | cr, toByteOffset: x, as: SIMD8<UInt16>.self)
+            } else {
+                rows.u.storeBytes(of: u, toByteOffset: x / 2, as: SIMD8<UInt8>.self)
+                rows.v.storeBytes(of: v, toByteOffset: x / 2, as: SIMD8<UInt8>.self)
+            }
+            x += 16
+        }
+        return x
+    }
+
+    @inline(__always)
+    private static func deinterleave(_ pixels: SIMD64<UInt8>) -> (b: SIMD16<UInt8>, g: SIMD16<UInt8>, r: SIMD16<UInt8>) {
+        let blueRed = pixels.evenHalf
+        let greenAlpha = pixels.oddHalf
+        return (blueRed.evenHalf, greenAlpha.evenHalf, blueRed.oddHalf)
+    }
+
+    @inline(__always)
+    private static func luma(_ b: SIMD16<UInt8>, _ g: SIMD16<UInt8>, _ r: SIMD16<UInt8>, _ m: YCbCrMatrix) -> SIMD16<UInt8> {
+        // Coefficients are positive and sum to 220, so 16-bit lanes cannot overflow.
+        let red = SIMD16<UInt16>(truncatingIfNeeded: r) &* UInt16(m.yr)
+        let green = SIMD16<UInt16>(truncatingIfNeeded: g) &* UInt16(m.yg)
+        let blue = SIMD16<UInt16>(truncatingIfNeeded: b) &* UInt16(m.yb)
+        let y = ((red &+ green &+ blue &+ 128) &>> 8) &+ 16
+        return SIMD16<UInt8>(truncatingIfNeeded: y)
+    }
+
+    @inline(__always)
+    private static func pairSum(_ top: SIMD16<UInt8>, _ bottom: SIMD16<UInt8>) -> SIMD8<Int32> {
+        let vertical = SIMD16<UInt16>(truncatingIfNeeded: top) &+ SIMD16<UInt16>(truncatingIfNeeded: bottom)
+        return SIMD8<Int32>(truncatingIfNeeded: vertical.evenHalf &+ vertical.oddHalf)
+    }
+
+    @inline(__always)
+    private static func chroma(_ sumR: SIMD8<Int32>, _ sumG: SIMD8<Int32>, _ sumB: SIMD8<Int32>,
+                               _ cr: Int32, _ cg: Int32, _ cb: Int32) -> SIMD8<UInt8> {
+        let weighted = sumR &* cr &+ sumG &* cg &+ sumB &* cb
+        let c = ((weighted &+ 512) &>> 10) &+ 128
+        return SIMD8<UInt8>(truncatingIfNeeded: c)
+    }
+}
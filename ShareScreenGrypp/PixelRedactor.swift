@@ -0,0 +1,291 @@
+import Foundation
+
+/// Integer pixel rectangle with a top-left origin.
+struct PixelRect: Equatable {
+    var x: Int
+    var y: Int
+    var width: Int
+    var height: Int
+
+    init(x: Int, y: Int, width: Int, height: Int) {
+        self.x = x
+        self.y = y
+        self.width = width
+        self.height = height
+    }
+
+    /// Smallest pixel rect containing `rect`, so partially covered edge pixels are redacted too.
+    init(covering rect: CGRect) {
+        let standardized = rect.standardized
+        let minX = Int(standardized.minX.rounded(.down))
+        let minY = Int(standardized.minY.rounded(.down))
+        let maxX = Int(standardized.maxX.rounded(.up))
+        let maxY = Int(standardized.maxY.rounded(.up))
+        self.init(x: minX, y: minY, width: maxX - minX, height: maxY - minY)
+    }
+
+    var maxX: Int { x + width }
+    var maxY: Int { y + height }
+    var isEmpty: Bool { width <= 0 || height <= 0 }
+
+    func clipped(width frameWidth: Int, height frameHeight: Int) -> PixelRect {
+        let minX = max(x, 0)
+        let minY = max(y, 0)
+        return PixelRect(x: minX, y: minY,
+                         width: max(0, min(maxX, frameWidth) - minX),
+                         height: max(0, min(maxY, frameHeight) - minY))
+    }
+}
+
+/// Redaction colour, stored premultiplied to match the BGRA frames it is blended into.
+struct RedactionColor: Equatable {
+    let blue: UInt8
+    let green: UInt8
+    let red: UInt8
+    let alpha: UInt8
+
+    init(red: Double, green: Double, blue: Double, alpha: Double) {
+        let a = min(max(alpha, 0), 1)
+        func premultiplied(_ component: Double) -> UInt8 {
+            return UInt8((min(max(component, 0), 1) * a * 255).rounded())
+        }
+        self.blue = premultiplied(blue)
+        self.green = premultiplied(green)
+        self.red = premultiplied(red)
+        self.alpha = UInt8((a * 255).rounded())
+    }
+
+    static let translucentBlack = RedactionColor(red: 0, green: 0, blue: 0, alpha: 0.7)
+}
+
+/// One area of a frame to redact and how.
+struct RedactionRegion: Equatable {
+    let rect: PixelRect
+    let action: RedactionAction
+}
+
+/// Applies redaction in place on a BGRA frame. Rects are clipped to the frame, bucketed
+/// into horizontal bands and merged into disjoint spans per row, so every covered pixel
+/// is touched exactly once: cost follows the covered area, not the number of rects, and
+/// overlapping translucent rects don't darken twice.
+final class PixelRedactor {
+
+    let bandHeight: Int
+    /// Edge length of the averaged blocks for `.mosaic`.
+    let mosaicBlockSize: Int
+    private let boxBlur: BoxBlur
+
+    // MARK: - Scratch
+    private var fillRects: [PixelRect] = []
+    private var clippedRects: [PixelRect] = []
+    /// Indices into `clippedRects` overlapping each band.
+    private var bands: [[Int]] = []
+    private var spanStarts: [Int] = []
+    private var spanEnds: [Int] = []
+    /// Per-channel column sums of one block row for `.mosaic`.
+    private var mosaicSums: [UInt16] = []
+
+    // MARK: - Init
+    init(bandHeight: Int = 32, blurRadius: Int = 6, mosaicBlockSize: Int = 12) {
+        precondition(bandHeight > 0, "bandHeight must be positive")
+        // Column sums of a block row are kept in 16 bits.
+        precondition((1...256).contains(mosaicBlockSize), "mosaicBlockSize must be in 1...256")
+        self.bandHeight = bandHeight
+        self.mosaicBlockSize = mosaicBlockSize
+        boxBlur = BoxBlur(radius: blurRadius)
+    }
+
+    // MARK: - Regions
+
+    /// Applies each region's action. Blur and mosaic run first so a fill overlapping them
+    /// still lands on top.
+    func apply(_ regions: [RedactionRegion], in buffer: FrameBuffer, color: RedactionColor) {
+        fillRects.removeAll(keepingCapacity: true)
+        for region in regions {
+            switch region.action {
+            case .fill:
+                fillRects.append(region.rect)
+            case .blur:
+                boxBlur.blur(region.rect, in: buffer)
+            case .mosaic:
+                pixelate(region.rect, in: buffer)
+            }
+        }
+        fill(fillRects, in: buffer, color: color)
+    }
+
+    // MARK: - Fill
+
+    /// Blends `color` over the union of `rects`.
+    func fill(_ rects: [PixelRect], in buffer: FrameBuffer, color: RedactionColor) {
+        precondition(buffer.format == .bgra, "only BGRA frames can be redacted")
+        let base = buffer.baseAddress()
+        let bytesPerRow = buffer.bytesPerRow()
+        forEachCoveredSpan(of: rects, width: buffer.width, height: buffer.height) { y, start, end in
+            PixelRedactor.blend(color, into: base + y * bytesPerRow, from: start, to: end)
+        }
+    }
+
+    /// Calls `body` with every maximal run of covered pixels, row by row, top to bottom.
+    func forEachCoveredSpan(of rects: [PixelRect], width: Int, height: Int,
+                            _ body: (_ y: Int, _ start: Int, _ end: Int) -> Void) {
+        clippedRects.removeAll(keepingCapacity: true)
+        for rect in rects {
+            let clipped = rect.clipped(width: width, height: height)
+            if !clipped.isEmpty {
+                clippedRects.append(clipped)
+            }
+        }
+        guard !clippedRects.isEmpty else { return }
+
+        let bandCount = (height + bandHeight - 1) / bandHeight
+        while bands.count < bandCount {
+            bands.append([])
+        }
+        for band in 0..<bandCount {
+            bands[band].removeAll(keepingCapacity: true)
+        }
+        for (index, rect) in clippedRects.enumerated() {
+            for band in (rect.y / bandHeight)...((rect.maxY - 1) / bandHeight) {
+                bands[band].append(index)
+            }
+        }
+
+        for band in 0..<bandCount where !bands[band].isEmpty {
+            let top = band * bandHeight
+            for y in top..<min(top + bandHeight, height) {
+                collectSpans(band: band, y: y)
+                var i = 0
+                while i < spanStarts.count {
+                    let start = spanStarts[i]
+                    var end = spanEnds[i]
+                    i += 1
+                    while i < spanStarts.count && spanStarts[i] <= end {
+                        end = max(end, spanEnds[i])
+                        i += 1
+                    }
+                    body(y, start, end)
+                }
+            }
+        }
+    }
+
+    /// Fills the span scratch with the rects of `band` covering row `y`, sorted by start.
+    private func collectSpans(band: Int, y: Int) {
+        spanStarts.removeAll(keepingCapacity: true)
+        spanEnds.removeAll(keepingCapacity: true)
+        for index in bands[band] {
+            let rect = clippedRects[index]
+            guard y >= rect.y && y < rect.maxY else { continue }
+            // Insertion sort; a row rarely crosses more than a handful of rects.
+            var position = spanStarts.count
+            spanStarts.append(rect.x)
+            spanEnds.append(rect.maxX)
+            while position > 0 && spanStarts[position - 1] > rect.x {
+                spanStarts.swapAt(position, position - 1)
+                spanEnds.swapAt(position, position - 1)
+                position -= 1
+            }
+        }
+    }
+
+    // MARK: - Mosaic
+
+    /// Replaces each `mosaicBlockSize` square of `rect` with its average colour. Blocks are
+    /// aligned to the frame, not the rect, so a moving field keeps a stable pattern. Each
+    /// pixel is read once into vector column sums and written once by a pattern store, so
+    /// the cost stays close to `fill`.
+    func pixelate(_ rect: PixelRect, in buffer: FrameBuffer) {
+        precondition(buffer.format == .bgra, "only BGRA frames can be redacted")
+        let target = rect.clipped(width: buffer.width, height: buffer.height)
+        guard !target.isEmpty else { return }
+        let block = mosaicBlockSize
+        let base = buffer.baseAddress()
+        let bytesPerRow = buffer.bytesPerRow()
+        let lanes = target.width * 4
+        let vectorLanes = lanes & ~63
+        if mosaicSums.count < lanes {
+            mosaicSums = [UInt16](repeating: 0, count: lanes)
+        }
+        mosaicSums.withUnsafeMutableBufferPointer { sums in
+            let raw = UnsafeMutableRawPointer(sums.baseAddress!)
+            var top = target.y
+            while top < target.maxY {
+                let bottom = min((top / block + 1) * block, target.maxY)
+                // Vertical pass: per-channel column sums over the block row, 16 pixels per step.
+                raw.initializeMemory(as: UInt16.self, repeating: 0, count: lanes)
+                for y in top..<bottom {
+                    let row = UnsafeRawPointer(base + y * bytesPerRow + target.x * 4)
+                    var lane = 0
+                    while lane < vectorLanes {
+                        let pixels = SIMD64<UInt16>(truncatingIfNeeded: row.loadUnaligned(fromByteOffset: lane, as: SIMD64<UInt8>.self))
+                        let partial = raw.loadUnaligned(fromByteOffset: lane * 2, as: SIMD64<UInt16>.self)
+                        raw.storeBytes(of: partial &+ pixels, toByteOffset: lane * 2, as: SIMD64<UInt16>.self)
+                        lane += 64
+                    }
+                    let bytes = row.assumingMemoryBound(to: UInt8.self)
+                    while lane < lanes {
+                        sums[lane] &+= UInt16(bytes[lane])
+                        lane += 1
+                    }
+                }
+                // Horizontal pass: reduce each block's columns, then store its average as a
+                // plain pattern fill.
+                var left = target.x
+                while left < target.maxX {
+                    let right = min((left / block + 1) * block, target.maxX)
+                    var sum = SIMD4<UInt32>()
+                    for column in (left - target.x)..<(right - target.x) {
+                        sum &+= SIMD4<UInt32>(truncatingIfNeeded: raw.loadUnaligned(fromByteOffset: column * 8, as: SIMD4<UInt16>.self))
+                    }
+                    let count = UInt32((bottom - top) * (right - left))
+                    let average = (sum &+ count / 2) / count
+                    let pattern = average[0] | average[1] << 8 | average[2] << 16 | average[3] << 24
+                    for y in top..<bottom {
+                        (base + y * bytesPerRow + left * 4).initializeMemory(as: UInt32.self, repeating: pattern, count: right - left)
+                    }
+                    left = right
+                }
+                top = bottom
+            }
+        }
+    }
+
+    // MARK: - Kernels
+
+    /// `out = color + pixel * (255 - alpha) / 255` on pixels `start..<end` of one row,
+    /// 16 pixels per iteration. Opaque colours become a plain pattern store.
+    static func blend(_ color: RedactionColor, into row: UnsafeMutableRawPointer, from start: Int, to end: Int) {
+        guard start < end else { return }
+        if color.alpha == 255 {
+            let pattern = UInt32(color.blue) | UInt32(color.green) << 8 | UInt32(color.red) << 16 | UInt32(color.alpha) << 24
+            (row + start * 4).initializeMemory(as: UInt32.self, repeating: pattern, count: end - start)
+            return
+        }
+
+        let inverse = UInt16(255 - color.alpha)
+        let channels = SIMD4<UInt16>(UInt16(color.blue), UInt16(color.green), UInt16(color.red), UInt16(color.alpha))
+        var x = start
+        if end - start >= 16 {
+            var overlay = SIMD64<UInt16>()
+            for lane in 0..<64 {
+                overlay[lane] = channels[lane & 3]
+            }
+            while x + 16 <= end {
+                let pixels = SIMD64<UInt16>(truncatingIfNeeded: UnsafeRawPointer(row).loadUnaligned(fromByteOffset: x * 4, as: SIMD64<UInt8>.self))
+                let scaled = pixels &* inverse &+ 128
+                let divided = (scaled &+ (scaled &>> 8)) &>> 8
+                row.storeBytes(of: SIMD64<UInt8>(truncatingIfNeeded: divided &+ overlay), toByteOffset: x * 4, as: SIMD64<UInt8>.self)
+                x += 16
+            }
+        }
+        let bytes = row.assumingMemoryBound(to: UInt8.self)
+        while x < end {
+            for c in 0..<4 {
+                let scaled = UInt16(bytes[x * 4 + c]) * inverse + 128
+                bytes[x * 4 + c] = UInt8((scaled + (scaled >> 8)) >> 8 + channels[c])
+            }
+            x += 1
+        }
+    }
+}
@@ -1,51 +1,59 @@
 import UIKit
-extension UIView {
-    func sensitiveSubviews(identifier: String = "sensitive") -> [UIView] {
-        var result: [UIView] = []
-        if self.accessibilityIdentifier == identifier {
-            result.append(self)
+extension UIView: RedactionInspectable {
+    var redactionClassNames: [String] {
+        var names: [String] = []
+        var current: AnyClass? = type(of: self)
+        while let cls = current {
+            names.append(NSStringFromClass(cls))
+            current = class_getSuperclass(cls)
         }
-        for subview in subviews {
-            result.append(contentsOf: subview.sensitiveSubviews(identifier: identifier))
-        }
-        return result
+        return names
     }
-}
 
-extension UIImage {
-    func redact(rect: CGRect, color: UIColor = UIColor(red: 0, green: 0, blue: 0, alpha: 0.7)) -> UIImage? {
-        UIGraphicsBeginImageContextWithOptions(size, false, scale)
-        draw(at: .zero)
-        color.setFill()
-        UIRectFill(rect)
-        let result = UIGraphicsGetImageFromCurrentImageContext()
-        UIGraphicsEndImageContext()
-        return result
+    var redactionIdentifier: String? {
+        return accessibilityIdentifier
     }
-}
-extension UIImage {
-    func redactWithBlur(in rect: CGRect) -> UIImage? {
-        guard let ciImage = CIImage(image: self) else { return nil }
-
-        let blurFilter = CIFilter(name: "CIGaussianBlur")
-        blurFilter?.setValue(ciImage, forKey: kCIInputImageKey)
-        blurFilter?.setValue(10.0, forKey: kCIInputRadiusKey)
-
-        guard let outputCIImage = blurFilter?.outputImage else { return nil }
-
-        let context = CIContext()
-        guard let cgImage = context.createCGImage(outputCIImage, from: ciImage.extent) else { return nil }
 
-        UIGraphicsBeginImageContextWithOptions(self.size, false, self.scale)
-        draw(at: .zero)
-
-        if let blurredPart = cgImage.cropping(to: rect) {
-            let blurredUIImage = UIImage(cgImage: blurredPart)
-            blurredUIImage.draw(in: rect)
+    var redactionIsSecureTextEntry: Bool {
+        if let field = self as? UITextField {
+            return field.isSecureTextEntry
+        }
+        if let textView = self as? UITextView {
+            return textView.isSecureTextEntry
         }
+        return false
+    }
 
-        let result = UIGraphicsGetImageFromCurrentImageContext()
-        UIGraphicsEndImageContext()
-        return result
+    /// The content type under the case name rules use (`"creditCardNumber"`, `"oneTimeCode"`),
+    /// independent of UIKit's underlying string values.
+    var redactionContentType: String? {
+        let type: UITextContentType?
+        if let field = self as? UITextField {
+            type = field.textContentType
+        } else if let textView = self as? UITextView {
+            type = textView.textContentType
+        } else {
+            return nil
+        }
+        switch type {
+        case .none:
+            return nil
+        case .some(.creditCardNumber):
+            return "creditCardNumber"
+        case .some(.password):
+            return "password"
+        case .some(.newPassword):
+            return "newPassword"
+        case .some(.oneTimeCode):
+            return "oneTimeCode"
+        case .some(.username):
+            return "username"
+        case .some(.emailAddress):
+            return "emailAddress"
+        case .some(.telephoneNumber):
+            return "telephoneNumber"
+        case .some(let other):
+            return other.rawValue
+        }
     }
 }
@@ -0,0 +1,195 @@
+import Foundation
+
+/// How a matched view is hidden in the shared frame.
+public enum RedactionAction {
+    /// Translucent black fill.
+    case fill
+    /// Box blur of the view's area.
+    case blur
+    /// Pixelation of the view's area.
+    case mosaic
+}
+
+public struct RedactionRule {
+
+    public enum Criterion {
+        /// The view's class or any superclass, with or without the module prefix.
+        case className(String)
+        /// Exact accessibility identifier.
+        case identifier(String)
+        case identifierPrefix(String)
+        /// Regular expression searched within the accessibility identifier.
+        case identifierPattern(String)
+        /// Text inputs with `isSecureTextEntry` set.
+        case secureTextEntry
+        /// `UITextContentType` raw value, e.g. `"creditCardNumber"`.
+        case contentType(String)
+    }
+
+    public let criterion: Criterion
+    public let action: RedactionAction
+
+    public init(_ criterion: Criterion, action: RedactionAction = .fill) {
+        self.criterion = criterion
+        self.action = action
+    }
+}
+
+/// Ordered redaction rules; when several match a view, the earliest wins.
+public struct RedactionPolicy {
+
+    public var rules: [RedactionRule]
+    /// Action for views marked through `GryppTokManager.markSensitive(_:)`.
+    public var markedViewAction: RedactionAction
+
+    public init(rules: [RedactionRule], markedViewAction: RedactionAction = .fill) {
+        self.rules = rules
+        self.markedViewAction = markedViewAction
+    }
+
+    /// The legacy `"sensitive"` tag plus password and payment-card inputs.
+    public static let standard = RedactionPolicy(rules: [
+        RedactionRule(.identifier("sensitive")),
+        RedactionRule(.secureTextEntry),
+        RedactionRule(.contentType("creditCardNumber")),
+        RedactionRule(.contentType("password")),
+        RedactionRule(.contentType("newPassword")),
+        RedactionRule(.contentType("oneTimeCode"))
+    ])
+}
+
+/// The attributes of a view that redaction rules look at.
+protocol RedactionInspectable: AnyObject {
+    /// Names of the concrete class and its superclasses. Only read the first time a class
+    /// is seen.
+    var redactionClassNames: [String] { get }
+    var redactionIdentifier: String? { get }
+    var redactionIsSecureTextEntry: Bool { get }
+    var redactionContentType: String? { get }
+}
+
+/// A `RedactionPolicy` compiled into lookup tables. Each criterion kind resolves with a
+/// hash lookup; class and identifier decisions are memoized, so the per-view cost doesn't
+/// grow with the number of rules.
+final class RedactionMatcher {
+
+    let policy: RedactionPolicy
+
+    private var classRules: [String: Int] = [:]
+    private var identifierRules: [String: Int] = [:]
+    private var prefixRules: [String: Int] = [:]
+    private var prefixLengths: [Int] = []
+    private var patternRules: [(expression: NSRegularExpression, rule: Int)] = []
+    private var secureTextEntryRule: Int?
+    private var contentTypeRules: [String: Int] = [:]
+
+    /// Memoized best rule per concrete class and per identifier; `-1` for no match.
+    private var classDecisions: [ObjectIdentifier: Int] = [:]
+    private var identifierDecisions: [String: Int] = [:]
+    static let identifierCacheLimit = 4096
+
+    // MARK: - Init
+
+    /// Compiles `policy`. Invalid identifier patterns are reported and skipped.
+    init(policy: RedactionPolicy) {
+        self.policy = policy
+        for (index, rule) in policy.rules.enumerated() {
+            switch rule.criterion {
+            case .className(let name):
+                classRules[name] = min(classRules[name] ?? index, index)
+            case .identifier(let identifier):
+                identifierRules[identifier] = min(identifierRules[identifier] ?? index, index)
+            case .identifierPrefix(let prefix):
+                prefixRules[prefix] = min(prefixRules[prefix] ?? index, index)
+            case .identifierPattern(let pattern):
+                do {
+                    patternRules.append((try NSRegularExpression(pattern: pattern), index))
+                } catch {
+                    Logger.capture.warning("❌ Invalid redaction pattern \(pattern): \(error)")
+                }
+            case .secureTextEntry:
+                secureTextEntryRule = min(secureTextEntryRule ?? index, index)
+            case .contentType(let type):
+                contentTypeRules[type] = min(contentTypeRules[type] ?? index, index)
+            }
+        }
+        prefixLengths = Set(prefixRules.keys.map { $0.count }).sorted()
+    }
+
+    // MARK: - Matching
+
+    func action<Node: RedactionInspectable>(for node: Node) -> RedactionAction? {
+        var best = classDecision(for: node)
+        if let identifier = node.redactionIdentifier, !identifier.isEmpty {
+            best = earliest(best, identifierDecision(for: identifier))
+        }
+        if let rule = secureTextEntryRule, node.redactionIsSecureTextEntry {
+            best = earliest(best, rule)
+        }
+        if !contentTypeRules.isEmpty, let type = node.redactionContentType, let rule = contentTypeRules[type] {
+            best = earliest(best, rule)
+        }
+        return best >= 0 ? policy.rules[best].action : nil
+    }
+
+    /// Depth-first scan from `root`, appending every matching node. Matched nodes are
+    /// redacted whole, so their descendants aren't visited.
+    func collectMatches<Node: RedactionInspectable>(in root: Node, children: (Node) -> [Node],
+                                                    into result: inout [(node: Node, action: RedactionAction)]) {
+        if let action = action(for: root) {
+            result.append((root, action))
+            return
+        }
+        for child in children(root) {
+            collectMatches(in: child, children: children, into: &result)
+        }
+    }
+
+    @inline(__always)
+    private func earliest(_ a: Int, _ b: Int) -> Int {
+        if a < 0 { return b }
+        if b < 0 { return a }
+        return min(a, b)
+    }
+
+    private func classDecision<Node: RedactionInspectable>(for node: Node) -> Int {
+        guard !classRules.isEmpty else { return -1 }
+        let key = ObjectIdentifier(type(of: node))
+        if let decision = classDecisions[key] {
+            return decision
+        }
+        var decision = -1
+        for name in node.redactionClassNames {
+            let unqualified = name.split(separator: ".").last.map(String.init) ?? name
+            for candidate in [name, unqualified] {
+                if let rule = classRules[candidate] {
+                    decision = earliest(decision, rule)
+                }
+            }
+        }
+        classDecisions[key] = decision
+        return decision
+    }
+
+    private func identifierDecision(for identifier: String) -> Int {
+        if let decision = identifierDecisions[identifier] {
+            return decision
+        }
+        var decision = identifierRules[identifier] ?? -1
+        for length in prefixLengths {
+            guard length <= identifier.count else { break }
+            if let rule = prefixRules[String(identifier.prefix(length))] {
+                decision = earliest(decision, rule)
+            }
+        }
+        let range = NSRange(identifier.startIndex..., in: identifier)
+        for (expression, rule) in patternRules where expression.firstMatch(in: identifier, range: range) != nil {
+            decision = earliest(decision, rule)
+        }
+        if identifierDecisions.count >= RedactionMatcher.identifierCacheLimit {
+            identifierDecisions.removeAll(keepingCapacity: true)
+        }
+        identifierDecisions[identifier] = decision
+        return decision
+    }
+}
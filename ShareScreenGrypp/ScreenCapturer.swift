@@ -2,6 +2,11 @@
 import UIKit
 import OpenTok
 
+public protocol ScreenCapturerStatisticsDelegate: AnyObject {
+    /// Called on the main thread every `statisticsReportInterval` while frames flow.
+    func screenCapturer(_ capturer: ScreenCapturer, didUpdate statistics: CaptureStatistics)
+}
+
 public class ScreenCapturer: NSObject, OTVideoCapture {
 
     // MARK: - OTVideoCapture Properties
@@ -11,27 +16,234 @@ public class ScreenCapturer: NSObject, OTVideoCapture {
     // MARK: - Capture State
     private var captureViewProvider: () -> UIView
     private let captureQueue = DispatchQueue(label: "com.grypp.captureQueue")
+    /// Runs the post-raster stages so the main thread only draws the hierarchy.
+    private let processingQueue = DispatchQueue(label: "com.grypp.captureProcessingQueue", qos: .userInitiated)
     private var timer: DispatchSourceTimer?
     private var capturing = false
     private var isTimerRunning = false
+    private let rateScheduler = CaptureRateScheduler()
+    private let coalescer = CaptureCoalescer()
+    private var activeTrigger = CaptureTrigger.runLoopCommits
+    private var commitObserver: CFRunLoopObserver?
+    /// Set on the main thread after our own raster work, so the run-loop pass it caused
+    /// isn't taken for a UI update.
+    private var ignoresNextCommit = false
+    private var isRasterPending = false
+    private let frameClock = FrameClock()
 
     // MARK: - Video Frame
     private var videoFrame = OTVideoFrame()
+    // One raster being drawn, two queued and one in the background stage.
+    private let bufferPool = FrameBufferPool(capacity: 4, maximumRetainedKeys: 4)
+    private let frameQueue = BoundedFrameQueue<PendingFrame>(capacity: 2)
+    private let downscaler = Downscaler(mode: .areaAverage)
+    private let colorSpace = CGColorSpace(name: CGColorSpace.sRGB)!
+    private let paddingColor = UIColor.white.cgColor
+    /// The format handed to OpenTok with each frame, rebuilt only when the output size
+    /// changes. Processing queue only.
+    private var videoFormat: (key: FrameBufferKey, format: OTVideoFormat)?
+
+    // MARK: - Counters
+    /// Guards the per-frame counters below, written on the capture and processing queues
+    /// and read from any thread.
+    private let countersLock = NSLock()
+    private var _droppedFrameCount = 0
+    private var _skippedFrameCount = 0
+    private var _lastChangedTileCount = 0
+    private var _lastTotalTileCount = 0
+    private var _lastStageTimings = CaptureStageTimings()
+
+    public var droppedFrameCount: Int {
+        return withCounters { _droppedFrameCount }
+    }
+
+    private func withCounters<T>(_ body: () -> T) -> T {
+        countersLock.lock()
+        defer { countersLock.unlock() }
+        return body()
+    }
+
+    // MARK: - Capture Mode
+    public enum CaptureMode {
+        /// Draw the view hierarchy once, directly into the output buffer at output size.
+        case singlePass
+        /// Rasterize at about screen scale, then shrink with `Downscaler`.
+        case snapshot
+        /// Rasterize at the screen's full native scale and shrink to output size, the
+        /// drawing cost of capture before the hierarchy was drawn at output scale. Only
+        /// the drawing is on the main thread here. The old path also resized and converted
+        /// there, so for its full main-thread cost add this mode's `resize` and
+        /// `conversion` stage times to `mainThreadHistogram(for: .nativeScale)`.
+        case nativeScale
+    }
+
+    public var captureMode: CaptureMode = .singlePass
+
+    // MARK: - Capture Trigger
+    public enum CaptureTrigger {
+        /// Capture after main run-loop passes that committed UI work, at most 15 fps, with a
+        /// heartbeat frame every second while idle.
+        case runLoopCommits
+        /// Poll on a timer whose rate `CaptureRateScheduler` adapts to screen activity.
+        case timer
+    }
+
+    /// Takes effect on the next `start()`.
+    public var captureTrigger: CaptureTrigger = .runLoopCommits
+    public var lastStageTimings: CaptureStageTimings {
+        return withCounters { _lastStageTimings }
+    }
+    private let maxOutputDimension: CGFloat = 1280.0
+    private let redactionColor = RedactionColor.translucentBlack
+    private let redactor = PixelRedactor()
+
+    /// Which views are redacted and how. Set on the main thread.
+    public var redactionPolicy = RedactionPolicy.standard {
+        didSet {
+            redactionMatcher = RedactionMatcher(policy: redactionPolicy)
+            setNeedsSensitiveRescan()
+        }
+    }
+    private var redactionMatcher = RedactionMatcher(policy: .standard)
+
+    // MARK: - Pipeline Metrics
+
+    /// Rasters waiting for the background stage.
+    public var queueDepth: Int {
+        return frameQueue.count
+    }
+
+    public var maximumQueueDepth: Int {
+        return frameQueue.counters.maximumDepth
+    }
+
+    /// Rasters discarded unprocessed because newer ones arrived while the background stage
+    /// was busy.
+    public var queueDroppedFrameCount: Int {
+        return frameQueue.counters.dropped
+    }
+
+    /// Time between consecutive captures, in nanoseconds.
+    public var frameIntervalHistogram: LatencyHistogram {
+        return frameClock.statistics.frameIntervals
+    }
+
+    /// Stage latencies and frame outcomes since `start()` or `resetStatistics()`.
+    public var statistics: CaptureStatistics {
+        return statisticsRecorder.snapshot()
+    }
+
+    public weak var statisticsDelegate: ScreenCapturerStatisticsDelegate?
+    public var statisticsReportInterval: TimeInterval = 5
+    private let statisticsRecorder = CaptureStatisticsRecorder()
+    private var lastStatisticsReport: UInt64 = 0
+
+    public func resetStatistics() {
+        statisticsRecorder.reset()
+    }
+
+    /// How far each capture interval strayed from the scheduled one, in nanoseconds.
+    public var captureJitterHistogram: LatencyHistogram {
+        return frameClock.statistics.jitter
+    }
+
+    private let mainThreadLock = NSLock()
+    private var mainThreadHistograms: [CaptureMode: LatencyHistogram] = [:]
+
+    /// Main-thread time per frame captured in `mode`, in nanoseconds. Switching
+    /// `captureMode` for a while compares the cost of each rasterization scale.
+    public func mainThreadHistogram(for mode: CaptureMode) -> LatencyHistogram {
+        mainThreadLock.lock()
+        defer { mainThreadLock.unlock() }
+        return mainThreadHistograms[mode]?.detachedCopy() ?? LatencyHistogram()
+    }
+
+    // MARK: - Dirty Detection
+    private let tileHasher = FrameTileHasher()
+    private let heartbeatInterval: UInt64 = 1_000_000_000
+    private var lastConsumedFrameTime: UInt64 = 0
+    public var lastChangedTileCount: Int {
+        return withCounters { _lastChangedTileCount }
+    }
+    public var lastTotalTileCount: Int {
+        return withCounters { _lastTotalTileCount }
+    }
+    public var skippedFrameCount: Int {
+        return withCounters { _skippedFrameCount }
+    }
+
+    // MARK: - Sensitive Views
+    private let sensitiveViews: SensitiveViewRegistry<UIView>
+    /// Also redact views matching `redactionPolicy`'s rules. The hierarchy is walked for
+    /// them on the first frame, when a walked view gains or loses subviews, and every
+    /// `sensitiveRevalidationInterval`; their rects are cached like marked views'. Apps
+    /// that mark every sensitive view through `GryppTokManager.markSensitive(_:)` can
+    /// turn it off.
+    /// Set on the main thread.
+    public var scansHierarchyWithPolicy = true {
+        didSet { setNeedsSensitiveRescan() }
+    }
+    /// Views matched by `redactionPolicy`, one registry per action.
+    private var policyViews: [RedactionAction: SensitiveViewRegistry<UIView>] = [:]
+    private var needsPolicyScan = true
+    private let layoutObserver = SensitiveLayoutObserver()
+    private weak var sensitiveRoot: UIView?
+    private let clock: MonotonicClock
+    private var lastSensitiveRevalidation: UInt64 = 0
+    /// Rescan and re-measure at least this often, to catch changes observation can't see:
+    /// a field turning on `isSecureTextEntry`, a content type or accessibility identifier
+    /// set on a view already on screen, a marked view moving to a new superview without
+    /// its frame changing. A match can show unredacted for up to this long. Set to nil
+    /// only if the app calls `setNeedsSensitiveRescan()` after every such change.
+    public var sensitiveRevalidationInterval: TimeInterval? = 0.5
+
+    /// Hierarchy walks made to find views matching `redactionPolicy`.
+    public private(set) var policyScanCount = 0
+
+    /// Frames whose marked-view rects came from the cache.
+    public var sensitiveRectCacheHits: Int {
+        return sensitiveViews.counters.hits
+    }
+
+    public var sensitiveRectRecomputes: Int {
+        return sensitiveViews.counters.recomputes
+    }
+
+    /// Cached rects shifted for a scroll instead of being recomputed.
+    public var sensitiveRectScrollAdjustments: Int {
+        return sensitiveViews.counters.scrollAdjustments
+    }
 
     // MARK: - Session/Orientation
     var session: OTSession?
     private var previousOrientation: UIDeviceOrientation = .unknown
 
     // MARK: - Init
-    init(captureViewProvider: @escaping () -> UIView) {
+    init(captureViewProvider: @escaping () -> UIView,
+         sensitiveViews: SensitiveViewRegistry<UIView> = SensitiveViewRegistry(),
+         clock: MonotonicClock = SystemMonotonicClock.shared) {
         self.captureViewProvider = captureViewProvider
+        self.sensitiveViews = sensitiveViews
+        self.clock = clock
         super.init()
+        layoutObserver.onLayoutChange = { [weak self] in
+            self?.invalidateSensitiveRects()
+        }
+        layoutObserver.onScroll = { [weak self] scrollView, delta in
+            self?.sensitiveRegistries.forEach {
+                $0.registry.scrollOffsetDidChange(of: ObjectIdentifier(scrollView), by: delta)
+            }
+        }
+        layoutObserver.onStructureChange = { [weak self] in
+            self?.setNeedsSensitiveRescan()
+        }
     }
 
     // MARK: - OTVideoCapture Methods
     public func initCapture() {
+        // One-shot timer; every capture re-arms it with the delay chosen by rateScheduler.
         timer = DispatchSource.makeTimerSource(queue: captureQueue)
-        timer?.schedule(deadline: .now(), repeating: .milliseconds(300))
+        timer?.schedule(deadline: .now())
         timer?.setEventHandler { [weak self] in
             self?.captureFrame()
         }
@@ -40,13 +252,24 @@ public class ScreenCapturer: NSObject, OTVideoCapture {
     public func start() -> Int32 {
         guard !capturing else { return 0 }
         capturing = true
-        print("📸 start capture")
+        Logger.capture.info("📸 start capture")
+        frameClock.resume()
+        statisticsRecorder.reset()
+        let trigger = captureTrigger
         captureQueue.async {
             if self.timer == nil {
                 self.initCapture()
             }
+            self.activeTrigger = trigger
+            self.coalescer.reset()
             self.timer?.resume()
             self.isTimerRunning = true
+            self.scheduleNextCapture(after: 0)
+        }
+        if trigger == .runLoopCommits {
+            DispatchQueue.main.async {
+                self.installCommitObserver()
+            }
         }
         return 0
     }
@@ -54,10 +277,13 @@ public class ScreenCapturer: NSObject, OTVideoCapture {
     public func stop() -> Int32 {
         guard capturing else { return 0 }
         capturing = false
-        print("🛑 stop capture")
+        Logger.capture.info("🛑 stop capture")
         captureQueue.async {
             self.timer?.suspend()
         }
+        DispatchQueue.main.async {
+            self.removeCommitObserver()
+        }
         return 0
     }
 
@@ -70,6 +296,9 @@ public class ScreenCapturer: NSObject, OTVideoCapture {
             }
             self.timer = nil
         }
+        DispatchQueue.main.async {
+            self.removeCommitObserver()
+        }
     }
 
     public func isCaptureStarted() -> Bool {
@@ -77,154 +306,434 @@ public class ScreenCapturer: NSObject, OTVideoCapture {
     }
 
     public func captureSettings(_ videoFormat: OTVideoFormat) -> Int32 {
-        videoFormat.pixelFormat = .ARGB
+        videoFormat.pixelFormat = .NV12
         return 0
     }
 
-    // MARK: - Frame Capture Logic
+    // MARK: - Capture Rate
 
-    private func captureFrame() {
-        DispatchQueue.main.async { [weak self] in
-            guard let self = self else { return }
-            guard let screenshot = self.snapshot(of: self.captureViewProvider()),
-                  let cgImage = self.resizeAndPad(image: screenshot),
-                  let pixelBuffer = self.cgImageToCVPixelBuffer(cgImage) else {
-                print("❌ Failed to capture or convert image")
+    /// Brings the next capture forward after a touch or animation if the capturer had
+    /// backed off while the screen was idle. Animations run in the render server without
+    /// main-thread commits, so with `.runLoopCommits` this keeps capturing at the maximum
+    /// rate for a while.
+    func noteActivity(_ activity: CaptureRateScheduler.Activity) {
+        captureQueue.async {
+            if self.activeTrigger == .runLoopCommits {
+                if let deadline = self.coalescer.noteActivity() {
+                    self.scheduleCapture(at: deadline)
+                }
                 return
             }
+            guard self.rateScheduler.noteActivity(activity) else { return }
+            self.scheduleNextCapture(after: self.rateScheduler.currentInterval)
+        }
+    }
+
+    private func scheduleNextCapture(after delay: UInt64) {
+        guard capturing else { return }
+        timer?.schedule(deadline: .now() + .nanoseconds(Int(delay)))
+    }
+
+    private func scheduleCapture(at deadline: UInt64) {
+        guard capturing else { return }
+        timer?.schedule(deadline: DispatchTime(uptimeNanoseconds: deadline))
+    }
+
+    // MARK: - Commit Trigger
+
+    /// Observes the main run loop just before it sleeps, after Core Animation has committed
+    /// that pass's changes. An idle run loop sleeps without coming back here.
+    private func installCommitObserver() {
+        guard commitObserver == nil, capturing else { return }
+        // Ordered after Core Animation's commit observer (2000000).
+        let observer = CFRunLoopObserverCreateWithHandler(kCFAllocatorDefault, CFRunLoopActivity.beforeWaiting.rawValue,
+                                                          true, 2_000_001) { [weak self] _, _ in
+            self?.runLoopDidCommit()
+        }
+        CFRunLoopAddObserver(CFRunLoopGetMain(), observer, .commonModes)
+        commitObserver = observer
+    }
+
+    private func removeCommitObserver() {
+        guard let observer = commitObserver else { return }
+        CFRunLoopObserverInvalidate(observer)
+        commitObserver = nil
+    }
+
+    private func runLoopDidCommit() {
+        guard !ignoresNextCommit else {
+            ignoresNextCommit = false
+            return
+        }
+        captureQueue.async {
+            guard let deadline = self.coalescer.noteUpdate() else { return }
+            self.scheduleCapture(at: deadline)
+        }
+    }
 
-            CVPixelBufferLockBaseAddress(pixelBuffer, .readOnly)
-            defer { CVPixelBufferUnlockBaseAddress(pixelBuffer, .readOnly) }
+    // MARK: - Frame Capture Logic
 
-            guard let baseAddress = CVPixelBufferGetBaseAddress(pixelBuffer) else {
-                print("❌ Failed to get baseAddress from pixel buffer")
+    /// A raster grabbed on the main thread, waiting for the background stage.
+    private struct PendingFrame {
+        let raster: FrameBuffer
+        let outputWidth: Int
+        let outputHeight: Int
+        /// Redaction rects in output pixels.
+        let redactions: [RedactionRegion]
+        let stamp: FrameClock.Stamp
+        var timings: CaptureStageTimings
+    }
+
+    private func captureFrame() {
+        let interval: UInt64
+        switch activeTrigger {
+        case .timer:
+            // Arm the next tick now so the cadence doesn't stretch with background work.
+            interval = rateScheduler.currentInterval
+            scheduleNextCapture(after: interval)
+            // A main thread that hasn't served the last request gets no new one.
+            guard !isRasterPending else { return }
+        case .runLoopCommits:
+            interval = coalescer.minimumInterval
+            // Retry a busy main thread at the rate cap; the pending update stays pending.
+            guard !isRasterPending else {
+                scheduleNextCapture(after: interval)
                 return
             }
-
-            let timestamp = CMTime(value: Int64(mach_absolute_time()), timescale: 1000)
-            self.videoFrame.timestamp = timestamp
-            self.videoFrame.orientation = .up
-            self.videoFrame.format = OTVideoFormat(argbWithWidth: UInt32(cgImage.width),
-                                                   height: UInt32(cgImage.height))
-            self.videoFrame.clearPlanes()
-            self.videoFrame.planes?.addPointer(baseAddress)
-            self.videoCaptureConsumer?.consumeFrame(self.videoFrame)
-        }
-    }
-
-    
-    private func snapshot(of view: UIView) -> UIImage? {
-        let renderer = UIGraphicsImageRenderer(bounds: view.bounds)
-        var image = renderer.image { context in
-            view.drawHierarchy(in: view.bounds, afterScreenUpdates: false)
-        }
-        let sensitiveViews = view.sensitiveSubviews()
-        for sensitiveView in sensitiveViews {
-            var rect = sensitiveView.convert(sensitiveView.bounds, to: view)
-            if let scrollView = sensitiveView.superview as? UIScrollView {
-                rect.origin.x -= scrollView.contentOffset.x
-                rect.origin.y -= scrollView.contentOffset.y
+            guard coalescer.fire() != nil else {
+                scheduleCapture(at: coalescer.deadline)
+                return
+            }
+            scheduleCapture(at: coalescer.deadline)
+        }
+        isRasterPending = true
+        DispatchQueue.main.async { [weak self] in
+            guard let self = self else { return }
+            if let frame = self.rasterizeOnMain(nominalInterval: interval), let evicted = self.frameQueue.push(frame) {
+                self.bufferPool.recycle(evicted.raster)
+                self.statisticsRecorder.count(.dropped)
             }
-            if let redacted = image.redact(rect: rect, color: UIColor(red: 0, green: 0, blue: 0, alpha: 0.7)) {
-                image = redacted
+            self.ignoresNextCommit = self.commitObserver != nil
+            self.captureQueue.async {
+                self.isRasterPending = false
+            }
+            self.processingQueue.async {
+                self.processPendingFrames()
             }
         }
-        return image
     }
 
-    private func resizeAndPad(image: UIImage) -> CGImage? {
-        guard let source = image.cgImage else {
-            print("Error: Failed to get CGImage from UIImage")
+    /// Main-thread stage: only the work UIKit requires there, i.e. drawing the hierarchy
+    /// and reading the sensitive views' geometry.
+    private func rasterizeOnMain(nominalInterval: UInt64) -> PendingFrame? {
+        let start = DispatchTime.now().uptimeNanoseconds
+        let stamp = frameClock.stamp(nominalInterval: nominalInterval)
+        let view = captureViewProvider()
+        guard view.bounds.width > 0, view.bounds.height > 0 else { return nil }
+        var timings = CaptureStageTimings()
+        let geometry = CaptureGeometry(viewSize: view.bounds.size, maximumDimension: maxOutputDimension)
+        let outputWidth = geometry.outputWidth
+        let outputHeight = geometry.outputHeight
+        let outputScale = geometry.outputScale
+
+        // singlePass draws straight at output scale, so drawHierarchy only produces the
+        // pixels that are sent.
+        let mode = captureMode
+        let screenScale = view.traitCollection.displayScale > 0 ? view.traitCollection.displayScale : UIScreen.main.scale
+        var rasterScale = outputScale
+        var rasterWidth = outputWidth
+        var rasterHeight = outputHeight
+        switch mode {
+        case .singlePass:
+            break
+        case .snapshot:
+            // Rasterize at an integer multiple of the output size, close to screen scale.
+            // On 2x and 3x screens the multiple is 2, which takes the 2:1 box path.
+            let factor = max(1, Int((screenScale / outputScale).rounded()))
+            rasterScale = outputScale * CGFloat(factor)
+            rasterWidth = outputWidth * factor
+            rasterHeight = outputHeight * factor
+        case .nativeScale:
+            rasterScale = max(screenScale, outputScale)
+            rasterWidth = Int((CGFloat(outputWidth) * rasterScale / outputScale).rounded(.up))
+            rasterHeight = Int((CGFloat(outputHeight) * rasterScale / outputScale).rounded(.up))
+        }
+        guard let raster = bufferPool.lease(width: rasterWidth, height: rasterHeight) else {
+            withCounters { _droppedFrameCount += 1 }
+            statisticsRecorder.count(.dropped)
             return nil
         }
-        let sourceSize = CGSize(width: source.width, height: source.height)
-        let (container, drawRect) = dimensions(forInputSize: sourceSize)
-        UIGraphicsBeginImageContextWithOptions(container, true, 1.0)
-        guard let context = UIGraphicsGetCurrentContext() else {
-            print("Error: Failed to get CGContext")
+        guard rasterize(view, into: raster, scale: rasterScale, timings: &timings) else {
+            Logger.capture.error("❌ Failed to capture or convert image")
+            statisticsRecorder.count(.failed)
+            bufferPool.recycle(raster)
             return nil
         }
-        context.translateBy(x: 0, y: container.height)
+        let toOutput = CGAffineTransform(scaleX: outputScale, y: outputScale)
+        let redactions = sensitiveRegions(in: view).map {
+            RedactionRegion(rect: PixelRect(covering: $0.rect.applying(toOutput)), action: $0.action)
+        }
+        timings.mainThread = DispatchTime.now().uptimeNanoseconds - start
+        mainThreadLock.lock()
+        mainThreadHistograms[mode, default: LatencyHistogram()].record(timings.mainThread)
+        mainThreadLock.unlock()
+        return PendingFrame(raster: raster, outputWidth: outputWidth, outputHeight: outputHeight,
+                            redactions: redactions, stamp: stamp, timings: timings)
+    }
+
+    private func processPendingFrames() {
+        while let frame = frameQueue.pop() {
+            let report = process(frame)
+            captureQueue.async {
+                _ = self.rateScheduler.frameCaptured(changedTiles: report?.changedTiles ?? 0,
+                                                     totalTiles: report?.totalTiles ?? 0)
+            }
+        }
+        reportStatisticsIfDue()
+    }
+
+    private func reportStatisticsIfDue() {
+        guard statisticsDelegate != nil else { return }
+        let now = DispatchTime.now().uptimeNanoseconds
+        guard now - lastStatisticsReport >= UInt64(max(statisticsReportInterval, 0) * 1_000_000_000) else { return }
+        lastStatisticsReport = now
+        let statistics = statisticsRecorder.snapshot()
+        DispatchQueue.main.async {
+            self.statisticsDelegate?.screenCapturer(self, didUpdate: statistics)
+        }
+    }
+
+    /// Background stage: scale, redact, dirty-check, convert and consume one raster.
+    private func process(_ frame: PendingFrame) -> FrameTileHasher.Report? {
+        var timings = frame.timings
+        defer {
+            withCounters { _lastStageTimings = timings }
+            statisticsRecorder.record(timings)
+        }
+        let raster = frame.raster
+        defer { bufferPool.recycle(raster) }
+
+        var buffer = raster
+        if raster.width != frame.outputWidth || raster.height != frame.outputHeight {
+            guard let output = bufferPool.lease(width: frame.outputWidth, height: frame.outputHeight) else {
+                withCounters { _droppedFrameCount += 1 }
+                statisticsRecorder.count(.dropped)
+                return nil
+            }
+            timings.measure(\.resize) {
+                downscaler.scale(raster, into: output)
+            }
+            timings.pixelBytesWritten += output.bytesPerRow() * output.height
+            buffer = output
+        }
+        defer {
+            if buffer !== raster {
+                bufferPool.recycle(buffer)
+            }
+        }
+
+        let regions = frame.redactions
+        timings.measure(\.redaction) {
+            redactor.apply(regions, in: buffer, color: redactionColor)
+        }
+
+        // Static screens are only re-sent as a heartbeat so the stream stays alive.
+        let report = tileHasher.update(baseAddress: buffer.baseAddress(),
+                                       width: buffer.width,
+                                       height: buffer.height,
+                                       bytesPerRow: buffer.bytesPerRow())
+        withCounters {
+            _lastChangedTileCount = report.changedTiles
+            _lastTotalTileCount = report.totalTiles
+        }
+        let now = DispatchTime.now().uptimeNanoseconds
+        guard report.isDirty || now - lastConsumedFrameTime >= heartbeatInterval else {
+            withCounters { _skippedFrameCount += 1 }
+            statisticsRecorder.count(.skipped)
+            return report
+        }
+        lastConsumedFrameTime = now
+
+        // Hand OpenTok planar YUV so it doesn't have to convert before encoding.
+        guard let yuv = bufferPool.lease(width: buffer.width, height: buffer.height, format: .nv12) else {
+            withCounters { _droppedFrameCount += 1 }
+            statisticsRecorder.count(.dropped)
+            return report
+        }
+        defer { bufferPool.recycle(yuv) }
+        timings.measure(\.conversion) {
+            PixelConverter.convert(buffer, into: yuv)
+        }
+        timings.pixelBytesWritten += yuv.byteCount
+
+        let timestamp = CMTime(value: frame.stamp.presentationTicks(timescale: 1_000_000), timescale: 1_000_000)
+        videoFrame.timestamp = timestamp
+        videoFrame.orientation = .up
+        videoFrame.format = format(for: yuv)
+        videoFrame.clearPlanes()
+        videoFrame.planes?.addPointer(yuv.baseAddress(ofPlane: 0))
+        videoFrame.planes?.addPointer(yuv.baseAddress(ofPlane: 1))
+        timings.measure(\.consume) {
+            videoCaptureConsumer?.consumeFrame(videoFrame)
+        }
+        statisticsRecorder.count(.sent)
+        return report
+    }
+
+    /// Draws the hierarchy into `buffer` at `scale` pixels per point, white-padded.
+    private func rasterize(_ view: UIView, into buffer: FrameBuffer, scale: CGFloat, timings: inout CaptureStageTimings) -> Bool {
+        guard let context = bitmapContext(for: buffer) else {
+            Logger.capture.error("Failed to create CGContext Data")
+            return false
+        }
+        context.saveGState()
+        defer { context.restoreGState() }
+        let bounds = CGRect(x: 0, y: 0, width: buffer.width, height: buffer.height)
+        context.setFillColor(paddingColor)
+        context.fill(bounds)
+        // UIKit draws top-down.
+        context.translateBy(x: 0, y: bounds.height)
         context.scaleBy(x: 1.0, y: -1.0)
-        context.clear(CGRect(origin: .zero, size: container))
-        context.setFillColor(UIColor.white.cgColor)
-        context.fill(CGRect(origin: .zero, size: container))
-        context.draw(source, in: drawRect)
-        let outputImage = UIGraphicsGetImageFromCurrentImageContext()
-        UIGraphicsEndImageContext()
-        guard let result = outputImage?.cgImage else {
-            print("Error: Failed to create output CGImage")
-            return nil
+
+        UIGraphicsPushContext(context)
+        defer { UIGraphicsPopContext() }
+        let drawRect = CGRect(origin: .zero, size: view.bounds.size).applying(CGAffineTransform(scaleX: scale, y: scale))
+        timings.measure(\.snapshot) {
+            _ = view.drawHierarchy(in: drawRect, afterScreenUpdates: false)
         }
-        return result
-    }
-
-    private func cgImageToCVPixelBuffer(_ cgImage: CGImage) -> CVPixelBuffer? {
-        let width = cgImage.width
-        let height = cgImage.height
-        let attributes: [String: Any] = [
-            kCVPixelBufferPixelFormatTypeKey as String: kCVPixelFormatType_32BGRA,
-            kCVPixelBufferWidthKey as String: width,
-            kCVPixelBufferHeightKey as String: height,
-            kCVPixelBufferBytesPerRowAlignmentKey as String: width * 4,
-            kCVPixelBufferIOSurfacePropertiesKey as String: [:]
-        ]
-        var pixelBuffer: CVPixelBuffer?
-        let status = CVPixelBufferCreate(
-            kCFAllocatorDefault,
-            width,
-            height,
-            kCVPixelFormatType_32BGRA,
-            attributes as CFDictionary,
-            &pixelBuffer
-        )
-        guard status == kCVReturnSuccess, let buffer = pixelBuffer else {
-            print("Error: Failed to create pixel buffer with status \(status)")
-            return nil
+        timings.pixelBytesWritten += buffer.bytesPerRow() * buffer.height
+        return true
+    }
+
+    /// Drops every cached sensitive rect and walks the hierarchy for policy matches again
+    /// on the next frame. Call on the main thread after changes observation can't see,
+    /// such as a view's accessibility identifier changing.
+    public func setNeedsSensitiveRescan() {
+        needsPolicyScan = true
+        invalidateSensitiveRects()
+    }
+
+    private func invalidateSensitiveRects() {
+        sensitiveRegistries.forEach { $0.registry.invalidate() }
+    }
+
+    /// Marked views first, then policy matches.
+    private var sensitiveRegistries: [(registry: SensitiveViewRegistry<UIView>, action: RedactionAction)] {
+        return [(sensitiveViews, redactionPolicy.markedViewAction)] + policyViews.map { ($0.value, $0.key) }
+    }
+
+    /// Redaction rects in `view`'s points. On a static or scrolling screen these come from
+    /// the registries' caches between revalidations, with no hierarchy walk or geometry work.
+    func sensitiveRegions(in view: UIView) -> [(rect: CGRect, action: RedactionAction)] {
+        let now = clock.nanoseconds
+        var revalidates = view !== sensitiveRoot
+        if let interval = sensitiveRevalidationInterval,
+           now - lastSensitiveRevalidation >= UInt64(max(interval, 0) * 1_000_000_000) {
+            revalidates = true
         }
-        let lockFlags = CVPixelBufferLockFlags(rawValue: 0)
-        let lockStatus = CVPixelBufferLockBaseAddress(buffer, lockFlags)
-        guard lockStatus == kCVReturnSuccess else {
-            print("Error: Failed to lock pixel buffer with status \(lockStatus)")
-            return nil
+        if revalidates {
+            sensitiveRoot = view
+            lastSensitiveRevalidation = now
+            setNeedsSensitiveRescan()
         }
-        defer { CVPixelBufferUnlockBaseAddress(buffer, lockFlags) }
-        guard let baseAddress = CVPixelBufferGetBaseAddress(buffer) else {
-            print("Error: Failed to get pixel buffer base address")
-            return nil
+        if needsPolicyScan {
+            needsPolicyScan = false
+            scanForPolicyMatches(in: view)
         }
-        let bytesPerRow = CVPixelBufferGetBytesPerRow(buffer)
-        let colorSpace = CGColorSpace(name: CGColorSpace.sRGB)!
-        let bitmapInfo = CGImageAlphaInfo.premultipliedFirst.rawValue | CGBitmapInfo.byteOrder32Little.rawValue
-        guard let context = CGContext(
-            data: baseAddress,
-            width: width,
-            height: height,
-            bitsPerComponent: 8,
-            bytesPerRow: bytesPerRow,
-            space: colorSpace,
-            bitmapInfo: bitmapInfo
-        ) else {
-            print("Error: Failed to create CGContext Data")
-            return nil
+
+        // Recompute all registries together so the observed chains cover every placed view.
+        let registries = sensitiveRegistries
+        if registries.contains(where: { !$0.registry.isCached }) {
+            invalidateSensitiveRects()
+        }
+        var placed: [UIView] = []
+        var recomputed = false
+        var regions: [(rect: CGRect, action: RedactionAction)] = []
+        for (registry, action) in registries {
+            let recomputes = registry.counters.recomputes
+            let rects = registry.rects(placing: { sensitiveView in
+                guard sensitiveView.isDescendant(of: view) else { return nil }
+                placed.append(sensitiveView)
+                return SensitiveViewRegistry<UIView>.Placement(rect: sensitiveView.convert(sensitiveView.bounds, to: view),
+                                                               scrollContainers: scrollContainers(of: sensitiveView, in: view))
+            })
+            recomputed = recomputed || registry.counters.recomputes != recomputes
+            regions += rects.map { (rect: $0, action: action) }
+        }
+        if recomputed {
+            layoutObserver.observe(chainsOf: placed, in: view)
+        }
+        return regions
+    }
+
+    /// Walks the hierarchy for views matching `redactionPolicy` and watches the walked
+    /// views for added and removed subviews, so the walk repeats only when that changes.
+    private func scanForPolicyMatches(in root: UIView) {
+        var matches: [(node: UIView, action: RedactionAction)] = []
+        var walked: [UIView] = []
+        if scansHierarchyWithPolicy {
+            policyScanCount += 1
+            redactionMatcher.collectMatches(in: root, children: { node in
+                walked.append(node)
+                return node.subviews
+            }, into: &matches)
+        }
+        var nodesByAction: [RedactionAction: [UIView]] = [:]
+        for match in matches where !sensitiveViews.contains(match.node) {
+            nodesByAction[match.action, default: []].append(match.node)
+        }
+        for action in Set(nodesByAction.keys).union(policyViews.keys) {
+            let registry = policyViews[action] ?? SensitiveViewRegistry<UIView>()
+            policyViews[action] = registry
+            registry.replaceAll(with: nodesByAction[action] ?? [])
+        }
+        layoutObserver.observeStructure(of: walked)
+    }
+
+    /// Scroll views between `sensitiveView` and `root` whose offset moves it on screen.
+    private func scrollContainers(of sensitiveView: UIView, in root: UIView) -> [ObjectIdentifier] {
+        var containers: [ObjectIdentifier] = []
+        var current = sensitiveView.superview
+        while let ancestor = current {
+            if ancestor is UIScrollView {
+                containers.append(ObjectIdentifier(ancestor))
+            }
+            if ancestor === root { break }
+            current = ancestor.superview
+        }
+        return containers
+    }
+
+    /// All pooled buffers of one size and format share a layout, so one format serves them.
+    private func format(for yuv: FrameBuffer) -> OTVideoFormat {
+        if let cached = videoFormat, cached.key == yuv.key {
+            return cached.format
         }
-        context.draw(cgImage, in: CGRect(x: 0, y: 0, width: width, height: height))
-        return buffer
+        let format = OTVideoFormat(nv12WithWidth: UInt32(yuv.width), height: UInt32(yuv.height))
+        format.bytesPerRow = NSMutableArray(array: [yuv.bytesPerRow(ofPlane: 0), yuv.bytesPerRow(ofPlane: 1)])
+        videoFormat = (yuv.key, format)
+        return format
     }
 
-    private func dimensions(forInputSize size: CGSize) -> (container: CGSize, rect: CGRect) {
-        let maxSize: CGFloat = 1280.0
-        let aspect = size.width / size.height
-        var container = CGSize.zero
-        if size.width > size.height {
-            container.width = maxSize
-            container.height = maxSize / aspect
-        } else {
-            container.height = maxSize
-            container.width = maxSize * aspect
+    /// Wraps a pooled buffer in a bitmap context; no pixel memory is allocated. The context
+    /// is kept with the buffer and reused whenever the buffer is leased again.
+    private func bitmapContext(for buffer: FrameBuffer) -> CGContext? {
+        // Only the capturer attaches anything, and only contexts.
+        if let attachment = buffer.attachment {
+            return (attachment as! CGContext)
         }
-        let rect = CGRect(x: 0, y: 0, width: container.width, height: container.height)
-        return (container, rect)
+        let bitmapInfo = CGImageAlphaInfo.premultipliedFirst.rawValue | CGBitmapInfo.byteOrder32Little.rawValue
+        let context = CGContext(
+            data: buffer.baseAddress(),
+            width: buffer.width,
+            height: buffer.height,
+            bitsPerComponent: 8,
+            bytesPerRow: buffer.bytesPerRow(),
+            space: colorSpace,
+            bitmapInfo: bitmapInfo
+        )
+        buffer.attachment = context
+        return context
     }
 }
 
@@ -0,0 +1,87 @@
+import UIKit
+
+/// Watches the views that position the marked sensitive views (each one and its ancestors
+/// up to the capture root) so cached redaction rects are only recomputed when layout
+/// actually changes. Scroll views report offset deltas separately so the cache can shift
+/// rects instead of recomputing them. Separately, the views a redaction-policy scan walked
+/// are watched for added and removed subviews, so the scan only repeats when the
+/// hierarchy changes.
+final class SensitiveLayoutObserver {
+
+    var onLayoutChange: (() -> Void)?
+    var onScroll: ((UIScrollView, CGPoint) -> Void)?
+    var onStructureChange: (() -> Void)?
+
+    private var observations: [ObjectIdentifier: [NSKeyValueObservation]] = [:]
+    private var structureObservations: [ObjectIdentifier: NSKeyValueObservation] = [:]
+
+    /// Replaces the observed set with the ancestor chains of `views` up to and including
+    /// `root`. Views already observed keep their observations.
+    func observe(chainsOf views: [UIView], in root: UIView) {
+        var wanted: [ObjectIdentifier: UIView] = [:]
+        for view in views {
+            var current: UIView? = view
+            while let node = current {
+                wanted[ObjectIdentifier(node)] = node
+                if node === root { break }
+                current = node.superview
+            }
+        }
+        for id in observations.keys where wanted[id] == nil {
+            observations.removeValue(forKey: id)
+        }
+        for (id, view) in wanted where observations[id] == nil {
+            observations[id] = makeObservations(for: view)
+        }
+    }
+
+    /// Replaces the views whose subviews are watched. Views already watched keep their
+    /// observations.
+    func observeStructure(of views: [UIView]) {
+        var wanted: [ObjectIdentifier: UIView] = [:]
+        for view in views {
+            wanted[ObjectIdentifier(view)] = view
+        }
+        for id in structureObservations.keys where wanted[id] == nil {
+            structureObservations.removeValue(forKey: id)
+        }
+        for (id, view) in wanted where structureObservations[id] == nil {
+            structureObservations[id] = view.layer.observe(\.sublayers, options: []) { [weak self] _, _ in
+                self?.onStructureChange?()
+            }
+        }
+    }
+
+    func removeAll() {
+        observations.removeAll()
+        structureObservations.removeAll()
+    }
+
+    private func makeObservations(for view: UIView) -> [NSKeyValueObservation] {
+        let isScrollView = view is UIScrollView
+        var tokens = [
+            view.layer.observe(\.position, options: [.old, .new]) { [weak self] _, change in
+                if change.oldValue != change.newValue {
+                    self?.onLayoutChange?()
+                }
+            },
+            // A scroll view's bounds origin is its content offset, reported by `onScroll`.
+            view.layer.observe(\.bounds, options: [.old, .new]) { [weak self] _, change in
+                guard let old = change.oldValue, let new = change.newValue else { return }
+                if isScrollView ? old.size != new.size : old != new {
+                    self?.onLayoutChange?()
+                }
+            },
+            view.layer.observe(\.transform, options: []) { [weak self] _, _ in
+                self?.onLayoutChange?()
+            }
+        ]
+        if let scrollView = view as? UIScrollView {
+            tokens.append(scrollView.observe(\.contentOffset, options: [.old, .new]) { [weak self] scrollView, change in
+                guard let old = change.oldValue, let new = change.newValue else { return }
+                self?.onScroll?(scrollView, CGPoint(x: new.x - old.x, y: new.y - old.y))
+            })
+        }
+        return tokens
+    }
+}
@@ -0,0 +1,138 @@
+import Foundation
+
+/// Views the host app has explicitly marked as sensitive, held weakly, with their redaction
+/// rects cached until something invalidates them. Generic over the node type so the
+/// bookkeeping can be exercised without UIKit.
+///
+/// Scrolling doesn't invalidate: cached rects inside a scroll container are shifted by the
+/// offset delta instead, so a static or scrolling screen does no geometry work per frame.
+///
+/// Not thread-safe; `ScreenCapturer` uses it from the main thread only.
+final class SensitiveViewRegistry<Node: AnyObject> {
+
+    /// Where a node sits in capture coordinates, and which scroll containers move it.
+    struct Placement {
+        var rect: CGRect
+        var scrollContainers: [ObjectIdentifier] = []
+    }
+
+    struct Counters {
+        /// `rects(_:)` calls answered from the cache.
+        var hits = 0
+        var recomputes = 0
+        /// Cached rects shifted for a scroll instead of being recomputed.
+        var scrollAdjustments = 0
+    }
+
+    private struct Entry {
+        weak var node: Node?
+    }
+
+    private var entries: [ObjectIdentifier: Entry] = [:]
+    private var cachedRects: [CGRect] = []
+    private var cachedContainers: [[ObjectIdentifier]] = []
+    private var isValid = false
+
+    /// Bumped whenever the cached rects are dropped.
+    private(set) var generation = 0
+    private(set) var counters = Counters()
+
+    // MARK: - Marking
+
+    func mark(_ node: Node) {
+        let id = ObjectIdentifier(node)
+        guard entries[id]?.node !== node else { return }
+        entries[id] = Entry(node: node)
+        invalidate()
+    }
+
+    func unmark(_ node: Node) {
+        let id = ObjectIdentifier(node)
+        guard entries[id]?.node === node else { return }
+        entries.removeValue(forKey: id)
+        invalidate()
+    }
+
+    /// Marks exactly `nodes` and unmarks the rest. Only invalidates if the set changed.
+    func replaceAll(with nodes: [Node]) {
+        var replaced: [ObjectIdentifier: Entry] = [:]
+        for node in nodes {
+            replaced[ObjectIdentifier(node)] = Entry(node: node)
+        }
+        let isUnchanged = replaced.count == entries.count
+            && replaced.allSatisfy { entries[$0.key]?.node === $0.value.node }
+        guard !isUnchanged else { return }
+        entries = replaced
+        invalidate()
+    }
+
+    func contains(_ node: Node) -> Bool {
+        return entries[ObjectIdentifier(node)]?.node === node
+    }
+
+    /// Marked nodes that are still alive.
+    var count: Int {
+        return entries.values.reduce(0) { $1.node == nil ? $0 : $0 + 1 }
+    }
+
+    // MARK: - Invalidation
+
+    /// Whether the next `rects(_:)` call is served from the cache.
+    var isCached: Bool {
+        return isValid
+    }
+
+    /// Drops the cached rects; the next `rects(_:)` call recomputes them. Call when layout
+    /// that positions a marked node changes.
+    func invalidate() {
+        guard isValid else { return }
+        isValid = false
+        generation += 1
+    }
+
+    /// Shifts the cached rects inside `container` after its content scrolled by `delta`
+    /// (new offset minus old).
+    func scrollOffsetDidChange(of container: ObjectIdentifier, by delta: CGPoint) {
+        guard isValid, delta != .zero else { return }
+        for index in cachedRects.indices where cachedContainers[index].contains(container) {
+            cachedRects[index] = cachedRects[index].offsetBy(dx: -delta.x, dy: -delta.y)
+            counters.scrollAdjustments += 1
+        }
+    }
+
+    // MARK: - Rects
+
+    /// Rects of the live marked nodes as reported by `frame`, which returns `nil` for a
+    /// node that is currently not on screen.
+    func rects(_ frame: (Node) -> CGRect?) -> [CGRect] {
+        return rects(placing: { node in frame(node).map { Placement(rect: $0) } })
+    }
+
+    /// Rects of the live marked nodes as placed by `place`. Served from the cache unless
+    /// invalidated; deallocated nodes are pruned on recompute.
+    func rects(placing place: (Node) -> Placement?) -> [CGRect] {
+        guard !isValid else {
+            counters.hits += 1
+            return cachedRects
+        }
+        counters.recomputes += 1
+        cachedRects.removeAll(keepingCapacity: true)
+        cachedContainers.removeAll(keepingCapacity: true)
+        var released: [ObjectIdentifier] = []
+        for (id, entry) in entries {
+            guard let node = entry.node else {
+                released.append(id)
+                continue
+            }
+            if let placement = place(node), !placement.rect.isEmpty {
+                cachedRects.append(placement.rect)
+                cachedContainers.append(placement.scrollContainers)
+            }
+        }
+        for id in released {
+            entries.removeValue(forKey: id)
+        }
+        isValid = true
+        return cachedRects
+    }
+}
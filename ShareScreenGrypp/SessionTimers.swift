@@ -0,0 +1,134 @@
+import Foundation
+
+/// Timeouts of one screen-share session.
+enum SessionTimer: Hashable {
+    /// Hides the customer's own touch cursor.
+    case localCursor
+    /// Hides the agent's cursor after a ping.
+    case agentCursor
+    /// Fades an annotation stroke, by draw event id.
+    case stroke(String)
+}
+
+/// Keyed timeouts on one `TimerWheel`, fired on `queue` by a single dispatch timer armed
+/// for the wheel's next wake-up. Scheduling a key that is already pending re-arms it
+/// instead of adding a second timer, so a burst of identical requests leaves one pending
+/// action. Timers due within the same wheel tick fire together.
+///
+/// Use from `queue` only. With a nil queue nothing fires on its own; call
+/// `fireDueTimers()` to drive it, as tests do with a `ManualClock`.
+final class SessionTimers<Key: Hashable> {
+
+    enum Rearm {
+        /// Replace the pending deadline: fire `delay` after the latest request.
+        case restart
+        /// Keep whichever deadline comes first.
+        case keepEarlier
+    }
+
+    private struct Entry {
+        let handle: TimerWheelHandle
+        let deadline: UInt64
+        let action: () -> Void
+    }
+
+    private let wheel: TimerWheel<Key>
+    private let clock: MonotonicClock
+    private let queue: DispatchQueue?
+    private let leeway: DispatchTimeInterval
+    private var entries: [Key: Entry] = [:]
+    private var timer: DispatchSourceTimer?
+    private var armedTick: UInt64?
+
+    var count: Int {
+        return entries.count
+    }
+
+    // MARK: - Init
+    init(tickDuration: TimeInterval = 0.01, clock: MonotonicClock = SystemMonotonicClock.shared,
+         queue: DispatchQueue? = .main) {
+        wheel = TimerWheel(tickDuration: tickDuration, clock: clock)
+        self.clock = clock
+        self.queue = queue
+        leeway = .nanoseconds(Int(wheel.tickDuration))
+    }
+
+    deinit {
+        timer?.cancel()
+    }
+
+    // MARK: - Scheduling
+
+    /// Runs `action` `delay` seconds from now, unless `key` is cancelled or re-armed first.
+    func schedule(_ key: Key, after delay: TimeInterval, rearm: Rearm = .restart, _ action: @escaping () -> Void) {
+        let deadline = clock.nanoseconds + UInt64(max(delay, 0) * 1_000_000_000)
+        if let pending = entries[key] {
+            if rearm == .keepEarlier && pending.deadline <= deadline {
+                return
+            }
+            wheel.cancel(pending.handle)
+        }
+        let handle = wheel.schedule(atNanoseconds: deadline, key)
+        entries[key] = Entry(handle: handle, deadline: deadline, action: action)
+        armTimer()
+    }
+
+    @discardableResult
+    func cancel(_ key: Key) -> Bool {
+        guard let pending = entries.removeValue(forKey: key) else { return false }
+        wheel.cancel(pending.handle)
+        return true
+    }
+
+    func isScheduled(_ key: Key) -> Bool {
+        return entries[key] != nil
+    }
+
+    func cancelAll() {
+        entries.removeAll()
+        wheel.removeAll()
+        armTimer()
+    }
+
+    // MARK: - Firing
+
+    /// Runs the actions of every timer that is due, in deadline order by tick, and
+    /// returns how many ran. An action may schedule or cancel timers, its own key
+    /// included.
+    @discardableResult
+    func fireDueTimers() -> Int {
+        var fired = 0
+        for key in wheel.advance() {
+            guard let entry = entries.removeValue(forKey: key) else { continue }
+            entry.action()
+            fired += 1
+        }
+        armTimer()
+        return fired
+    }
+
+    /// Points the dispatch timer at the wheel's next wake-up, or parks it.
+    private func armTimer() {
+        guard let queue = queue else { return }
+        let wakeTick = wheel.nextWakeTick
+        guard wakeTick != armedTick else { return }
+        armedTick = wakeTick
+        let source: DispatchSourceTimer
+        if let timer = timer {
+            source = timer
+        } else {
+            source = DispatchSource.makeTimerSource(queue: queue)
+            source.setEventHandler { [weak self] in
+                self?.armedTick = nil
+                self?.fireDueTimers()
+            }
+            source.resume()
+            timer = source
+        }
+        if let wakeTick = wakeTick {
+            source.schedule(deadline: DispatchTime(uptimeNanoseconds: wakeTick * wheel.tickDuration), leeway: leeway)
+        } else {
+            source.schedule(deadline: .distantFuture)
+        }
+    }
+}
@@ -0,0 +1,240 @@
+import Foundation
+
+struct TimerWheelHandle: Hashable {
+    fileprivate let index: Int32
+    fileprivate let generation: UInt32
+}
+
+/// Hierarchical timer wheel: four levels of 64 slots, each level's slot spanning 64 of
+/// the level below, so timers up to 64⁴ ticks out are placed and cancelled in O(1) and
+/// only cascade down a level when their slot comes around. Timers never fire early; they
+/// fire on the first tick at or after their deadline, so timers due within the same tick
+/// fire together. Empty stretches of the wheel are skipped rather than ticked through.
+///
+/// Not thread-safe; drive it from one thread.
+final class TimerWheel<Payload> {
+
+    static var levelCount: Int { return 4 }
+    static var slotsPerLevel: Int { return 64 }
+
+    let tickDuration: UInt64
+    private let clock: MonotonicClock
+    private(set) var currentTick: UInt64
+    private(set) var count = 0
+
+    // Timer storage, indexed by handle. Free entries are chained through `next`.
+    private var payloads: [Payload?] = []
+    private var expiries: [UInt64] = []
+    private var generations: [UInt32] = []
+    private var next: [Int32] = []
+    private var previous: [Int32] = []
+    private var entrySlots: [Int32] = []
+    private var freeHead: Int32 = -1
+
+    // Slot lists and which slots of each level are occupied.
+    private var heads: [Int32]
+    private var occupied: [UInt64]
+
+    // MARK: - Init
+    init(tickDuration: TimeInterval = 0.01, clock: MonotonicClock = SystemMonotonicClock.shared) {
+        precondition(tickDuration > 0, "tickDuration must be positive")
+        self.tickDuration = max(UInt64(tickDuration * 1_000_000_000), 1)
+        self.clock = clock
+        currentTick = clock.nanoseconds / self.tickDuration
+        heads = [Int32](repeating: -1, count: TimerWheel.levelCount * TimerWheel.slotsPerLevel)
+        occupied = [UInt64](repeating: 0, count: TimerWheel.levelCount)
+    }
+
+    // MARK: - Scheduling
+
+    /// Schedules `payload` to fire `delay` seconds from now.
+    @discardableResult
+    func schedule(after delay: TimeInterval, _ payload: Payload) -> TimerWheelHandle {
+        let deadline = clock.nanoseconds + UInt64(max(delay, 0) * 1_000_000_000)
+        return schedule(atNanoseconds: deadline, payload)
+    }
+
+    /// Schedules `payload` to fire at `deadline` on the wheel's clock.
+    @discardableResult
+    func schedule(atNanoseconds deadline: UInt64, _ payload: Payload) -> TimerWheelHandle {
+        let expiry = max((deadline + tickDuration - 1) / tickDuration, currentTick + 1)
+        let index = allocate()
+        payloads[index] = payload
+        expiries[index] = expiry
+        place(Int32(index))
+        count += 1
+        return TimerWheelHandle(index: Int32(index), generation: generations[index])
+    }
+
+    /// Removes the timer if it hasn't fired yet. Returns its payload if it was pending.
+    @discardableResult
+    func cancel(_ handle: TimerWheelHandle) -> Payload? {
+        guard isPending(handle) else { return nil }
+        let index = Int(handle.index)
+        let payload = payloads[index]
+        unlink(handle.index)
+        release(index)
+        count -= 1
+        return payload
+    }
+
+    func isPending(_ handle: TimerWheelHandle) -> Bool {
+        let index = Int(handle.index)
+        return index >= 0 && index < generations.count && generations[index] == handle.generation
+            && payloads[index] != nil
+    }
+
+    func removeAll() {
+        for index in payloads.indices where payloads[index] != nil {
+            release(index)
+        }
+        heads = [Int32](repeating: -1, count: heads.count)
+        occupied = [UInt64](repeating: 0, count: occupied.count)
+        count = 0
+    }
+
+    // MARK: - Advancing
+
+    /// Runs the wheel up to the clock's current time and returns the payloads that came
+    /// due, in deadline order (by tick). Timers scheduled while handling them fire on a
+    /// later call at the earliest.
+    func advance() -> [Payload] {
+        return advance(toTick: clock.nanoseconds / tickDuration)
+    }
+
+    /// The earliest tick `advance()` needs to run at: the next occupied slot of the lowest
+    /// level, or the next cascade of the lowest occupied level above it, whichever comes
+    /// first. Nil when nothing is pending.
+    var nextWakeTick: UInt64? {
+        guard count > 0 else { return nil }
+        var wake = UInt64.max
+        if occupied[0] != 0 {
+            // Level 0 holds expiries in the 63 ticks after the current one.
+            let shift = UInt64((currentTick + 1) & 63)
+            let rotated = occupied[0] >> shift | occupied[0] << (64 - shift)
+            wake = currentTick + 1 + UInt64(rotated.trailingZeroBitCount)
+        }
+        if let level = occupied.indices.dropFirst().first(where: { occupied[$0] != 0 }) {
+            let span = UInt64(1) << UInt64(6 * level)
+            wake = min(wake, (currentTick / span + 1) * span)
+        }
+        return wake
+    }
+
+    private func advance(toTick target: UInt64) -> [Payload] {
+        var due: [Payload] = []
+        while currentTick < target {
+            // Nothing can fire or cascade between here and the next wake tick.
+            guard let tick = nextWakeTick, tick <= target else {
+                currentTick = target
+                break
+            }
+            currentTick = tick
+            cascade()
+            collect(slot: Int(tick & 63), into: &due)
+        }
+        return due
+    }
+
+    /// At level boundaries, moves the timers of the slot that just came around down to
+    /// their place relative to the new current tick.
+    private func cascade() {
+        var level = 1
+        while level < TimerWheel.levelCount {
+            let shift = UInt64(6 * level)
+            guard currentTick & ((UInt64(1) << shift) - 1) == 0 else { break }
+            let slot = level * TimerWheel.slotsPerLevel + Int((currentTick >> shift) & 63)
+            var index = heads[slot]
+            heads[slot] = -1
+            occupied[level] &= ~(UInt64(1) << UInt64(slot & 63))
+            while index >= 0 {
+                let following = next[Int(index)]
+                place(index)
+                index = following
+            }
+            level += 1
+        }
+    }
+
+    private func collect(slot: Int, into due: inout [Payload]) {
+        var index = heads[slot]
+        guard index >= 0 else { return }
+        heads[slot] = -1
+        occupied[0] &= ~(UInt64(1) << UInt64(slot))
+        while index >= 0 {
+            let following = next[Int(index)]
+            if let payload = payloads[Int(index)] {
+                due.append(payload)
+            }
+            release(Int(index))
+            count -= 1
+            index = following
+        }
+    }
+
+    // MARK: - Slots
+
+    /// Links a timer into the slot for its expiry relative to `currentTick`.
+    private func place(_ index: Int32) {
+        let expiry = expiries[Int(index)]
+        let delta = expiry > currentTick ? expiry - currentTick : 0
+        var level = 0
+        while level < TimerWheel.levelCount - 1 && delta >= UInt64(1) << UInt64(6 * (level + 1)) {
+            level += 1
+        }
+        // Beyond the top level's reach: park in the farthest slot and re-place on cascade.
+        let reach = UInt64(1) << UInt64(6 * TimerWheel.levelCount)
+        let target = delta < reach ? expiry : currentTick + reach - 1
+        let digit = Int((target >> UInt64(6 * level)) & 63)
+        let slot = level * TimerWheel.slotsPerLevel + digit
+        let head = heads[slot]
+        next[Int(index)] = head
+        previous[Int(index)] = -1
+        if head >= 0 {
+            previous[Int(head)] = index
+        }
+        heads[slot] = index
+        entrySlots[Int(index)] = Int32(slot)
+        occupied[level] |= UInt64(1) << UInt64(digit)
+    }
+
+    private func unlink(_ index: Int32) {
+        let slot = Int(entrySlots[Int(index)])
+        let before = previous[Int(index)]
+        let after = next[Int(index)]
+        if before >= 0 {
+            next[Int(before)] = after
+        } else {
+            heads[slot] = after
+        }
+        if after >= 0 {
+            previous[Int(after)] = before
+        }
+        if heads[slot] < 0 {
+            occupied[slot / TimerWheel.slotsPerLevel] &= ~(UInt64(1) << UInt64(slot % TimerWheel.slotsPerLevel))
+        }
+    }
+
+    private func allocate() -> Int {
+        if freeHead >= 0 {
+            let index = Int(freeHead)
+            freeHead = next[index]
+            return index
+        }
+        payloads.append(nil)
+        expiries.append(0)
+        generations.append(0)
+        next.append(-1)
+        previous.append(-1)
+        entrySlots.append(-1)
+        return payloads.count - 1
+    }
+
+    /// Returns an entry to the free list; bumping its generation invalidates its handle.
+    private func release(_ index: Int) {
+        payloads[index] = nil
+        generations[index] &+= 1
+        next[index] = freeHead
+        freeHead = Int32(index)
+    }
+}
@@ -5,17 +5,17 @@ class TouchCaptureView: UIView {
         return nil // Pass the touch through
     }
     override func touchesBegan(_ touches: Set<UITouch>, with event: UIEvent?) {
-        print("touchesBegan")
+        Logger.touch.trace("touchesBegan")
         reportTouches(touches, type: "began")
     }
 
     override func touchesMoved(_ touches: Set<UITouch>, with event: UIEvent?) {
-        print("touchesMoved>>>>>>>")
+        Logger.touch.trace("touchesMoved")
         reportTouches(touches, type: "moved")
     }
 
     override func touchesEnded(_ touches: Set<UITouch>, with event: UIEvent?) {
-        print("touchesEnded>>>>>>>")
+        Logger.touch.trace("touchesEnded")
         reportTouches(touches, type: "ended")
     }
 
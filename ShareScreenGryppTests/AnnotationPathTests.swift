@@ -0,0 +1,158 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class AnnotationPathTests: XCTestCase {
+
+    private func command(_ name: String, _ numbers: CGFloat...) -> [PathCommandValue] {
+        return [.string(name)] + numbers.map { .number($0) }
+    }
+
+    /// A freehand stroke the way Fabric's pencil brush encodes it: a quadratic through
+    /// the midpoint of every pair of pointer samples. The pointer traces a looping
+    /// signature at about two points per sample, with sub-point jitter.
+    static func pencilStroke(samples: Int) -> [[PathCommandValue]] {
+        var state: UInt64 = 0x9E37_79B9_7F4A_7C15
+        func jitter() -> CGFloat {
+            state = state &* 6364136223846793005 &+ 1442695040888963407
+            return CGFloat(state >> 40) / CGFloat(1 << 24) * 0.3 - 0.15
+        }
+        let points: [CGPoint] = (0..<samples).map { index in
+            let t = Double(index) / 40
+            return CGPoint(x: 60 + t * 24 + 50 * sin(t * 2.3) + Double(jitter()),
+                           y: 400 + 80 * sin(t * 1.1) * cos(t * 0.4) + Double(jitter()))
+        }
+        var path: [[PathCommandValue]] = [[.string("M"), .number(points[0].x), .number(points[0].y)]]
+        for index in 1..<(samples - 1) {
+            let control = points[index]
+            let next = points[index + 1]
+            path.append([.string("Q"), .number(control.x), .number(control.y),
+                         .number((control.x + next.x) / 2), .number((control.y + next.y) / 2)])
+        }
+        path.append([.string("L"), .number(points[samples - 1].x), .number(points[samples - 1].y)])
+        return path
+    }
+
+    /// Points along `elements`, with quadratics sampled finely enough to stand in for them.
+    private func flatten(_ elements: [AnnotationPathElement]) -> [CGPoint] {
+        var points: [CGPoint] = []
+        var current = CGPoint.zero
+        for element in elements {
+            switch element {
+            case let .move(to), let .line(to):
+                points.append(to)
+                current = to
+            case let .quadCurve(to, control):
+                for step in 1...8 {
+                    let t = CGFloat(step) / 8
+                    let u = 1 - t
+                    points.append(CGPoint(x: u * u * current.x + 2 * u * t * control.x + t * t * to.x,
+                                          y: u * u * current.y + 2 * u * t * control.y + t * t * to.y))
+                }
+                current = to
+            case let .curve(to, _, _):
+                points.append(to)
+                current = to
+            case .closeSubpath:
+                break
+            }
+        }
+        return points
+    }
+
+    private func distance(from point: CGPoint, toPolyline polyline: [CGPoint]) -> CGFloat {
+        var best = CGFloat.greatestFiniteMagnitude
+        for index in 1..<polyline.count {
+            best = min(best, AnnotationPathBuilder.squaredDistance(from: point, toSegment: polyline[index - 1], polyline[index]))
+        }
+        return best.squareRoot()
+    }
+
+    // MARK: - Commands
+
+    func testKeepsCurveSemantics() {
+        let builder = AnnotationPathBuilder()
+        let elements = builder.append([
+            command("M", 0, 0),
+            command("Q", 10, 20, 20, 0),
+            command("C", 30, 10, 40, -10, 50, 0),
+            command("L", 50, 30),
+            command("Z")
+        ])
+        XCTAssertEqual(elements, [
+            .move(to: CGPoint(x: 0, y: 0)),
+            .quadCurve(to: CGPoint(x: 20, y: 0), control: CGPoint(x: 10, y: 20)),
+            .curve(to: CGPoint(x: 50, y: 0), control1: CGPoint(x: 30, y: 10), control2: CGPoint(x: 40, y: -10)),
+            .line(to: CGPoint(x: 50, y: 30)),
+            .closeSubpath
+        ])
+        XCTAssertEqual(builder.commandCount, 5)
+    }
+
+    func testRelativeCommandsAndMalformedInput() {
+        let builder = AnnotationPathBuilder()
+        XCTAssertEqual(builder.append([command("L", 5, 5), command("Q", 1, 2)]), [])
+        XCTAssertEqual(builder.append([command("M", 10, 10), command("l", 5, 0), command("q", 5, 5, 10, 0),
+                                       [.string("L"), .string("x"), .number(3)], [.number(1), .number(2)]]), [
+            .move(to: CGPoint(x: 10, y: 10)),
+            .line(to: CGPoint(x: 15, y: 10)),
+            .quadCurve(to: CGPoint(x: 25, y: 10), control: CGPoint(x: 20, y: 15))
+        ])
+        XCTAssertEqual(builder.commandCount, 3)
+    }
+
+    // MARK: - Simplification
+
+    func testCollapsesNearlyStraightRuns() {
+        let builder = AnnotationPathBuilder(tolerance: 0.5)
+        var commands = [command("M", 0, 0)]
+        for x in 1...200 {
+            commands.append(command("Q", CGFloat(x) - 0.5, x % 2 == 0 ? 0.2 : -0.2, CGFloat(x), 0))
+        }
+        XCTAssertEqual(builder.append(commands), [.move(to: .zero), .line(to: CGPoint(x: 200, y: 0))])
+    }
+
+    func testKeepsCornersBeyondTolerance() {
+        let builder = AnnotationPathBuilder(tolerance: 0.5)
+        let elements = builder.append([
+            command("M", 0, 0), command("L", 10, 0.2), command("L", 20, 0),
+            command("L", 20, 10), command("L", 20.2, 20), command("L", 20, 30)
+        ])
+        XCTAssertEqual(elements, [.move(to: .zero), .line(to: CGPoint(x: 20, y: 0)), .line(to: CGPoint(x: 20, y: 30))])
+    }
+
+    func testPencilStrokeStaysWithinTolerance() {
+        let stroke = AnnotationPathTests.pencilStroke(samples: 400)
+        let original = flatten(AnnotationPathBuilder(tolerance: 0).append(stroke))
+        var previousCount = stroke.count
+        for tolerance: CGFloat in [0.25, 0.5, 1] {
+            let builder = AnnotationPathBuilder(tolerance: tolerance)
+            let simplified = builder.append(stroke)
+            XCTAssertLessThan(simplified.count, previousCount, "\(tolerance)")
+            previousCount = simplified.count
+            let outline = flatten(simplified)
+            for point in original {
+                XCTAssertLessThanOrEqual(distance(from: point, toPolyline: outline), tolerance + 0.05, "\(tolerance)")
+            }
+        }
+    }
+
+    func testBatchesContinueTheStroke() {
+        let stroke = AnnotationPathTests.pencilStroke(samples: 300)
+        let builder = AnnotationPathBuilder()
+        let first = builder.append(Array(stroke[..<150]))
+        let second = builder.append(Array(stroke[150...]))
+        guard case .move? = first.first else { return XCTFail("stroke must start with a move") }
+        XCTAssertFalse(second.contains { if case .move = $0 { return true } else { return false } })
+        XCTAssertEqual(builder.elementCount, first.count + second.count)
+        XCTAssertEqual(builder.commandCount, stroke.count)
+    }
+
+    // MARK: - Benchmarks
+
+    func testPerformanceSimplifyPencilStroke() {
+        let stroke = AnnotationPathTests.pencilStroke(samples: 2_000)
+        measure {
+            XCTAssertGreaterThan(AnnotationPathBuilder().append(stroke).count, 1)
+        }
+    }
+}
@@ -0,0 +1,85 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class BoundedFrameQueueTests: XCTestCase {
+
+    func testPopsInOrder() {
+        let queue = BoundedFrameQueue<Int>(capacity: 3)
+        XCTAssertNil(queue.push(1))
+        XCTAssertNil(queue.push(2))
+        XCTAssertEqual(queue.count, 2)
+        XCTAssertEqual(queue.pop(), 1)
+        XCTAssertEqual(queue.pop(), 2)
+        XCTAssertNil(queue.pop())
+    }
+
+    func testFullQueueDropsOldest() {
+        let queue = BoundedFrameQueue<Int>(capacity: 2)
+        queue.push(1)
+        queue.push(2)
+        XCTAssertEqual(queue.push(3), 1)
+        XCTAssertEqual(queue.push(4), 2)
+        XCTAssertEqual(queue.removeAll(), [3, 4])
+
+        let counters = queue.counters
+        XCTAssertEqual(counters.pushed, 4)
+        XCTAssertEqual(counters.dropped, 2)
+        XCTAssertEqual(counters.popped, 2)
+        XCTAssertEqual(counters.maximumDepth, 2)
+    }
+
+    func testWrapsAroundAfterInterleavedUse() {
+        let queue = BoundedFrameQueue<Int>(capacity: 3)
+        var expected = 0
+        for value in 0..<10 {
+            queue.push(value)
+            if value % 2 == 1 {
+                XCTAssertEqual(queue.pop(), expected)
+                expected += 1
+            }
+        }
+        XCTAssertEqual(queue.count, 3)
+        XCTAssertEqual(queue.removeAll(), [7, 8, 9])
+    }
+
+    /// A slow consumer sees every frame it pops in order and the producer never blocks;
+    /// whatever it missed shows up as drops.
+    func testProducerConsumerAccounting() {
+        let queue = BoundedFrameQueue<Int>(capacity: 2)
+        let total = 10_000
+        let consumed = expectation(description: "consumer finished")
+        var received: [Int] = []
+        DispatchQueue.global().async {
+            var last = -1
+            while last < total - 1 {
+                if let value = queue.pop() {
+                    XCTAssertGreaterThan(value, last)
+                    last = value
+                    received.append(value)
+                }
+            }
+            consumed.fulfill()
+        }
+        for value in 0..<total {
+            queue.push(value)
+        }
+        wait(for: [consumed], timeout: 10)
+        let counters = queue.counters
+        XCTAssertEqual(counters.popped, received.count)
+        XCTAssertEqual(counters.popped + counters.dropped, total)
+    }
+
+    // MARK: - Benchmarks
+
+    func testPerformancePushPop() {
+        let queue = BoundedFrameQueue<Int>(capacity: 2)
+        measure {
+            for value in 0..<100_000 {
+                queue.push(value)
+                if value % 3 == 0 {
+                    _ = queue.pop()
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,129 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class BoxBlurTests: XCTestCase {
+
+    private let pool = FrameBufferPool(capacity: 3, maximumRetainedKeys: 4)
+
+    /// Black text-like strokes on white, the typical content of a redacted field.
+    private func makeFrame(width: Int = 592, height: Int = 1280) throws -> FrameBuffer {
+        let buffer = try XCTUnwrap(pool.lease(width: width, height: height))
+        for y in 0..<height {
+            let row = (buffer.baseAddress() + y * buffer.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+            for x in 0..<width {
+                let ink: UInt8 = (x / 3 + y / 5) % 4 == 0 ? 0x10 : 0xF8
+                row[x * 4] = ink
+                row[x * 4 + 1] = ink
+                row[x * 4 + 2] = UInt8(truncatingIfNeeded: x)
+                row[x * 4 + 3] = 0xFF
+            }
+        }
+        return buffer
+    }
+
+    private func bytes(_ buffer: FrameBuffer) -> [[UInt8]] {
+        return (0..<buffer.height).map { y in
+            Array(UnsafeRawBufferPointer(start: buffer.baseAddress() + y * buffer.bytesPerRow(), count: buffer.width * 4))
+        }
+    }
+
+    /// Direct-form reference: each pass averages the clamped `2r+1` window per pixel.
+    private func referenceBlur(_ image: [[UInt8]], radius: Int) -> [[UInt8]] {
+        var image = image.map { $0.map(Int.init) }
+        let height = image.count
+        let width = image[0].count / 4
+        let window = 2 * radius + 1
+        for _ in 0..<BoxBlur.passes {
+            var horizontal = image
+            for y in 0..<height {
+                for x in 0..<width {
+                    for c in 0..<4 {
+                        let sum = (-radius...radius).reduce(0) { $0 + image[y][min(max(x + $1, 0), width - 1) * 4 + c] }
+                        horizontal[y][x * 4 + c] = (sum + window / 2) / window
+                    }
+                }
+            }
+            for y in 0..<height {
+                for x in 0..<width {
+                    for c in 0..<4 {
+                        let sum = (-radius...radius).reduce(0) { $0 + horizontal[min(max(y + $1, 0), height - 1)][x * 4 + c] }
+                        image[y][x * 4 + c] = (sum + window / 2) / window
+                    }
+                }
+            }
+        }
+        return image.map { $0.map { UInt8($0) } }
+    }
+
+    // MARK: - Correctness
+
+    func testMatchesReferenceInsideTheTarget() throws {
+        let frame = try makeFrame(width: 48, height: 40)
+        let original = bytes(frame)
+        BoxBlur(radius: 2).blur(PixelRect(x: 0, y: 0, width: 48, height: 40), in: frame)
+        XCTAssertEqual(bytes(frame), referenceBlur(original, radius: 2))
+    }
+
+    func testRegionMatchesFullFrameBlurWhenApronFits() throws {
+        let frame = try makeFrame(width: 96, height: 80)
+        let original = bytes(frame)
+        let target = PixelRect(x: 30, y: 25, width: 30, height: 20)
+        BoxBlur(radius: 3).blur(target, in: frame)
+        let reference = referenceBlur(original, radius: 3)
+        let blurred = bytes(frame)
+        for y in 0..<80 {
+            let inside = (target.y..<target.maxY).contains(y)
+            for x in 0..<96 {
+                let expected = inside && (target.x..<target.maxX).contains(x) ? reference[y] : original[y]
+                XCTAssertEqual(blurred[y][x * 4..<x * 4 + 4], expected[x * 4..<x * 4 + 4], "(\(x), \(y))")
+            }
+        }
+    }
+
+    func testFlatRegionStaysFlat() throws {
+        let frame = try XCTUnwrap(pool.lease(width: 64, height: 64))
+        memset(frame.baseAddress(), 0x5A, frame.byteCount)
+        BoxBlur().blur(PixelRect(x: -10, y: 50, width: 100, height: 40), in: frame)
+        XCTAssertEqual(Set(bytes(frame).joined()), [0x5A])
+    }
+
+    // MARK: - Benchmarks
+
+    /// Three 400x60 px text fields on a 592x1280 frame.
+    private let fields = [PixelRect(x: 96, y: 300, width: 400, height: 60),
+                          PixelRect(x: 96, y: 420, width: 400, height: 60),
+                          PixelRect(x: 96, y: 540, width: 400, height: 60)]
+
+    func testPerformanceRegionBlur() throws {
+        let frame = try makeFrame()
+        let blur = BoxBlur(radius: 6)
+        measure {
+            for _ in 0..<10 {
+                for field in fields {
+                    blur.blur(field, in: frame)
+                }
+            }
+        }
+    }
+
+    /// The approach `UIImage.redactWithBlur` took: blur the whole image for each field,
+    /// then keep only the field.
+    func testPerformanceFullImageBlurBaseline() throws {
+        let frame = try makeFrame()
+        let scratch = try makeFrame()
+        let blur = BoxBlur(radius: 6)
+        let whole = PixelRect(x: 0, y: 0, width: frame.width, height: frame.height)
+        measure {
+            for _ in 0..<10 {
+                for field in fields {
+                    memcpy(scratch.baseAddress(), frame.baseAddress(), frame.byteCount)
+                    blur.blur(whole, in: scratch)
+                    for y in field.y..<field.maxY {
+                        let offset = y * frame.bytesPerRow() + field.x * 4
+                        memcpy(frame.baseAddress() + offset, scratch.baseAddress() + offset, field.width * 4)
+                    }
+                }
+            }
+        }
+    }
+}
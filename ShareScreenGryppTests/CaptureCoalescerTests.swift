@@ -0,0 +1,135 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class CaptureCoalescerTests: XCTestCase {
+
+    private var clock: ManualClock!
+    private var coalescer: CaptureCoalescer!
+
+    override func setUpWithError() throws {
+        clock = ManualClock(nanoseconds: 1_000_000_000)
+        var configuration = CaptureCoalescer.Configuration()
+        configuration.maximumFramesPerSecond = 16
+        configuration.heartbeatInterval = 1
+        coalescer = CaptureCoalescer(configuration: configuration, clock: clock)
+    }
+
+    /// Plays `updates` (milliseconds from now, ascending) against a timer that fires at each
+    /// deadline, for `duration` milliseconds. Returns the capture times and triggers.
+    private func simulate(updates: [Double], duration: Double) -> [(time: Double, trigger: CaptureCoalescer.Trigger)] {
+        let start = clock.nanoseconds
+        func elapsed() -> Double { Double(clock.nanoseconds - start) / 1_000_000 }
+        var captures: [(time: Double, trigger: CaptureCoalescer.Trigger)] = []
+        var remaining = updates[...]
+        while true {
+            let timerTime = Double(coalescer.deadline - min(coalescer.deadline, start)) / 1_000_000
+            let nextUpdate = remaining.first ?? .infinity
+            let next = min(timerTime, nextUpdate)
+            guard next <= duration else { break }
+            if next > elapsed() {
+                clock.advance(milliseconds: next - elapsed())
+            }
+            if nextUpdate <= timerTime {
+                remaining.removeFirst()
+                coalescer.noteUpdate()
+            } else if let trigger = coalescer.fire() {
+                captures.append((elapsed(), trigger))
+            }
+        }
+        return captures
+    }
+
+    // MARK: - Triggering
+
+    func testFirstUpdateIsCapturedImmediately() {
+        XCTAssertEqual(coalescer.noteUpdate(), clock.nanoseconds)
+        XCTAssertEqual(coalescer.fire(), .update)
+        XCTAssertFalse(coalescer.hasPendingUpdate)
+    }
+
+    func testIdleScreenOnlyGetsHeartbeats() {
+        let captures = simulate(updates: [], duration: 3_500)
+        XCTAssertEqual(captures.map { $0.time }, [0, 1_000, 2_000, 3_000])
+        XCTAssertTrue(captures.allSatisfy { $0.trigger == .heartbeat })
+        XCTAssertEqual(coalescer.counters.updateCaptures, 0)
+    }
+
+    func testUpdateAfterIdleIsNotDelayedToTheHeartbeat() {
+        // A 30 ms transition in the middle of an idle second.
+        let captures = simulate(updates: [400, 430], duration: 999)
+        XCTAssertEqual(captures.count, 3)
+        XCTAssertEqual(captures[1].time, 400)
+        XCTAssertEqual(captures[1].trigger, .update)
+        // The second update lands inside the rate cap and is captured at the cap.
+        XCTAssertEqual(captures[2].time, 462.5)
+        XCTAssertEqual(captures[2].trigger, .update)
+    }
+
+    func testBurstCoalescesIntoOneCapture() {
+        XCTAssertNotNil(coalescer.noteUpdate())
+        XCTAssertEqual(coalescer.fire(), .update)
+        clock.advance(milliseconds: 10)
+        let deadline = coalescer.noteUpdate()
+        XCTAssertEqual(deadline, clock.nanoseconds + 52_500_000)
+        for _ in 0..<20 {
+            clock.advance(milliseconds: 1)
+            XCTAssertNil(coalescer.noteUpdate())
+        }
+        XCTAssertEqual(coalescer.deadline, deadline)
+        XCTAssertEqual(coalescer.counters.coalescedUpdates, 20)
+    }
+
+    func testContinuousUpdatesAreCappedAtMaximumRate() {
+        // 120 Hz of commits for one second.
+        let updates = (0..<120).map { Double($0) * 1_000 / 120 }
+        let captures = simulate(updates: updates, duration: 999)
+        XCTAssertEqual(captures.count, 16)
+        XCTAssertTrue(captures.allSatisfy { $0.trigger == .update })
+        for (previous, next) in zip(captures, captures.dropFirst()) {
+            XCTAssertGreaterThanOrEqual(next.time - previous.time, 62.5)
+        }
+    }
+
+    func testEarlyFireIsIgnored() {
+        coalescer.noteUpdate()
+        XCTAssertEqual(coalescer.fire(), .update)
+        clock.advance(milliseconds: 500)
+        XCTAssertNil(coalescer.fire())
+        clock.advance(milliseconds: 500)
+        XCTAssertEqual(coalescer.fire(), .heartbeat)
+    }
+
+    func testActivityKeepsCapturingAtMaximumRateForTheHold() {
+        XCTAssertEqual(coalescer.fire(), .heartbeat)
+        clock.advance(milliseconds: 100)
+        coalescer.noteActivity()
+        // No further commits: captures continue at the cap until the 500 ms hold ends.
+        let captures = simulate(updates: [], duration: 1_500)
+        XCTAssertEqual(captures.map { $0.time }, [0, 62.5, 125, 187.5, 250, 312.5, 375, 437.5, 500, 1_500])
+        XCTAssertEqual(captures.dropLast().filter { $0.trigger == .update }.count, 9)
+        XCTAssertEqual(captures.last?.trigger, .heartbeat)
+    }
+
+    func testResetCapturesNextUpdateImmediately() {
+        coalescer.noteUpdate()
+        _ = coalescer.fire()
+        clock.advance(milliseconds: 1)
+        coalescer.reset()
+        XCTAssertEqual(coalescer.noteUpdate(), clock.nanoseconds)
+    }
+
+    // MARK: - Benchmarks
+
+    /// One capture per 16 updates, the ratio of a 240 Hz commit stream under a 15 fps cap.
+    func testPerformanceUpdateStream() {
+        measure {
+            for _ in 0..<100_000 {
+                for _ in 0..<16 {
+                    clock.advance(milliseconds: 4)
+                    coalescer.noteUpdate()
+                }
+                _ = coalescer.fire()
+            }
+        }
+    }
+}
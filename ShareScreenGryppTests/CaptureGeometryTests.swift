@@ -0,0 +1,28 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class CaptureGeometryTests: XCTestCase {
+
+    func testPortraitScalesHeightToMaximum() {
+        // iPhone 15 Pro Max in points.
+        let geometry = CaptureGeometry(viewSize: CGSize(width: 430, height: 932), maximumDimension: 1280)
+        XCTAssertEqual(geometry.outputHeight, 1280)
+        XCTAssertEqual(geometry.outputWidth, 592)
+        XCTAssertEqual(geometry.outputScale, 1280 / 932, accuracy: 1e-9)
+    }
+
+    func testLandscapeScalesWidthToMaximum() {
+        let geometry = CaptureGeometry(viewSize: CGSize(width: 1366, height: 1024), maximumDimension: 1280)
+        XCTAssertEqual(geometry.outputWidth, 1280)
+        XCTAssertEqual(geometry.outputHeight, 960)
+    }
+
+    func testDimensionsAreRoundedUpToEven() {
+        for width in stride(from: 300, to: 500, by: 3) {
+            let geometry = CaptureGeometry(viewSize: CGSize(width: width, height: 917), maximumDimension: 1280)
+            XCTAssertEqual(geometry.outputWidth % 2, 0)
+            XCTAssertEqual(geometry.outputHeight % 2, 0)
+            XCTAssertGreaterThanOrEqual(CGFloat(geometry.outputWidth), CGFloat(width) * geometry.outputScale)
+        }
+    }
+}
@@ -0,0 +1,73 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class CaptureRateSchedulerTests: XCTestCase {
+
+    private let totalTiles = 760
+    private var clock: ManualClock!
+    private var scheduler: CaptureRateScheduler!
+
+    override func setUpWithError() throws {
+        clock = ManualClock(nanoseconds: 1_000_000_000)
+        var configuration = CaptureRateScheduler.Configuration()
+        configuration.minimumFramesPerSecond = 1
+        configuration.maximumFramesPerSecond = 16
+        configuration.activityHold = 0.5
+        configuration.backoffMultiplier = 2
+        scheduler = CaptureRateScheduler(configuration: configuration, clock: clock)
+    }
+
+    /// Simulates the capture loop: waits for the returned delay, then reports the frame.
+    private func capture(changedTiles: Int) -> UInt64 {
+        let delay = scheduler.frameCaptured(changedTiles: changedTiles, totalTiles: totalTiles)
+        clock.advance(by: delay)
+        return delay
+    }
+
+    func testStartsAtMaximumRate() {
+        XCTAssertEqual(scheduler.currentInterval, 62_500_000)
+        XCTAssertEqual(scheduler.framesPerSecond, 16, accuracy: 0.001)
+    }
+
+    func testIdleBacksOffExponentiallyToMinimumRate() {
+        let delays = (0..<6).map { _ in capture(changedTiles: 0) }
+        XCTAssertEqual(delays, [125_000_000, 250_000_000, 500_000_000, 1_000_000_000, 1_000_000_000, 1_000_000_000])
+    }
+
+    func testChangedFramesHoldMaximumRate() {
+        for _ in 0..<20 {
+            XCTAssertEqual(capture(changedTiles: 200), 62_500_000)
+        }
+    }
+
+    func testActivityHoldDelaysBackoff() {
+        _ = capture(changedTiles: 200)
+        // 0.5 s hold at 62.5 ms per frame: the first seven idle frames stay fast.
+        let delays = (0..<9).map { _ in capture(changedTiles: 0) }
+        XCTAssertEqual(Array(delays.prefix(7)), Array(repeating: 62_500_000, count: 7))
+        XCTAssertEqual(delays[7], 125_000_000)
+        XCTAssertEqual(delays[8], 250_000_000)
+    }
+
+    func testMinorChangesDoNotCountAsActivity() {
+        let delays = (0..<3).map { _ in capture(changedTiles: 1) }
+        XCTAssertEqual(delays, [125_000_000, 250_000_000, 500_000_000])
+    }
+
+    func testTouchResetsBackoffAndAsksForReschedule() {
+        for _ in 0..<5 { _ = capture(changedTiles: 0) }
+        XCTAssertEqual(scheduler.currentInterval, 1_000_000_000)
+        XCTAssertTrue(scheduler.noteActivity(.touch))
+        XCTAssertEqual(scheduler.currentInterval, 62_500_000)
+        XCTAssertFalse(scheduler.noteActivity(.animation))
+        XCTAssertEqual(capture(changedTiles: 0), 62_500_000)
+    }
+
+    func testPerformanceDecisions() {
+        measure {
+            for i in 0..<200_000 {
+                _ = capture(changedTiles: i % 64 == 0 ? 100 : 0)
+            }
+        }
+    }
+}
@@ -0,0 +1,99 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class CaptureStatisticsTests: XCTestCase {
+
+    private func timings(snapshot: UInt64, resize: UInt64 = 0, consume: UInt64 = 0) -> CaptureStageTimings {
+        var timings = CaptureStageTimings()
+        timings.snapshot = snapshot
+        timings.redaction = 200_000
+        timings.resize = resize
+        timings.conversion = 1_500_000
+        timings.consume = consume
+        timings.mainThread = snapshot + 300_000
+        return timings
+    }
+
+    // MARK: - Recording
+
+    func testRecordsOnlyStagesThatRan() {
+        let recorder = CaptureStatisticsRecorder()
+        recorder.record(timings(snapshot: 8_000_000, resize: 2_000_000, consume: 500_000))
+        recorder.record(timings(snapshot: 12_000_000))
+        let statistics = recorder.snapshot()
+        XCTAssertEqual(statistics.snapshot.count, 2)
+        XCTAssertEqual(statistics.redaction.count, 2)
+        XCTAssertEqual(statistics.conversion.count, 2)
+        XCTAssertEqual(statistics.mainThread.count, 2)
+        XCTAssertEqual(statistics.resize.count, 1)
+        XCTAssertEqual(statistics.consume.count, 1)
+        XCTAssertEqual(statistics.snapshot.minimum, 8_000_000)
+        XCTAssertEqual(statistics.snapshot.maximum, 12_000_000)
+        XCTAssertEqual(statistics.mainThread.mean, 10_300_000, accuracy: 1)
+    }
+
+    func testCountsOutcomes() {
+        let recorder = CaptureStatisticsRecorder()
+        for _ in 0..<5 { recorder.count(.sent) }
+        for _ in 0..<3 { recorder.count(.skipped) }
+        recorder.count(.dropped)
+        recorder.count(.failed)
+        recorder.count(.failed)
+        let statistics = recorder.snapshot()
+        XCTAssertEqual(statistics.sentFrames, 5)
+        XCTAssertEqual(statistics.skippedFrames, 3)
+        XCTAssertEqual(statistics.droppedFrames, 1)
+        XCTAssertEqual(statistics.failedFrames, 2)
+    }
+
+    func testSnapshotIsIndependentOfLaterRecording() {
+        let recorder = CaptureStatisticsRecorder()
+        recorder.record(timings(snapshot: 5_000_000))
+        recorder.count(.sent)
+        let before = recorder.snapshot()
+        recorder.record(timings(snapshot: 50_000_000))
+        recorder.count(.sent)
+        XCTAssertEqual(before.snapshot.count, 1)
+        XCTAssertEqual(before.snapshot.maximum, 5_000_000)
+        XCTAssertEqual(before.sentFrames, 1)
+        XCTAssertEqual(recorder.snapshot().snapshot.count, 2)
+    }
+
+    func testReset() {
+        let recorder = CaptureStatisticsRecorder()
+        recorder.record(timings(snapshot: 5_000_000, resize: 1_000_000, consume: 1_000_000))
+        recorder.count(.dropped)
+        recorder.reset()
+        let statistics = recorder.snapshot()
+        XCTAssertEqual(statistics.snapshot.count, 0)
+        XCTAssertEqual(statistics.resize.count, 0)
+        XCTAssertEqual(statistics.droppedFrames, 0)
+    }
+
+    func testConcurrentRecordingLosesNothing() {
+        let recorder = CaptureStatisticsRecorder()
+        DispatchQueue.concurrentPerform(iterations: 8) { _ in
+            for index in 0..<1_000 {
+                recorder.record(timings(snapshot: UInt64(index + 1) * 1_000))
+                recorder.count(.sent)
+            }
+        }
+        let statistics = recorder.snapshot()
+        XCTAssertEqual(statistics.snapshot.count, 8_000)
+        XCTAssertEqual(statistics.sentFrames, 8_000)
+    }
+
+    // MARK: - Benchmarks
+
+    /// The per-frame cost on the processing queue: one timings record and one outcome.
+    func testPerformanceRecord() {
+        let recorder = CaptureStatisticsRecorder()
+        let frame = timings(snapshot: 9_000_000, resize: 2_000_000, consume: 400_000)
+        measure {
+            for _ in 0..<100_000 {
+                recorder.record(frame)
+                recorder.count(.sent)
+            }
+        }
+    }
+}
@@ -0,0 +1,189 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class DownscalerTests: XCTestCase {
+
+    private let pool = FrameBufferPool(capacity: 4, maximumRetainedKeys: 8)
+
+    /// Screen-like content: flat background, text-like high-frequency stripes and a
+    /// smooth gradient band.
+    private func makeScreen(width: Int, height: Int) throws -> FrameBuffer {
+        let buffer = try XCTUnwrap(pool.lease(width: width, height: height))
+        for y in 0..<height {
+            let row = (buffer.baseAddress() + y * buffer.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+            for x in 0..<width {
+                let value: UInt8
+                if y % 120 < 30 && x > 40 && x < width - 40 {
+                    value = (x / 3 + y / 2) % 4 == 0 ? 0x20 : 0xF0
+                } else if y > height / 2 && y < height / 2 + 200 {
+                    value = UInt8(x * 255 / width)
+                } else {
+                    value = 0xFA
+                }
+                row[x * 4] = value
+                row[x * 4 + 1] = value
+                row[x * 4 + 2] = UInt8(truncatingIfNeeded: Int(value) + y % 7)
+                row[x * 4 + 3] = 0xFF
+            }
+        }
+        return buffer
+    }
+
+    private func fill(_ buffer: FrameBuffer, with value: UInt8) {
+        for y in 0..<buffer.height {
+            (buffer.baseAddress() + y * buffer.bytesPerRow()).initializeMemory(as: UInt8.self, repeating: value, count: buffer.width * 4)
+        }
+    }
+
+    /// Exact floating-point area average, the quality reference for every mode.
+    private func referenceAreaAverage(_ source: FrameBuffer, width: Int, height: Int) throws -> FrameBuffer {
+        let destination = try XCTUnwrap(pool.lease(width: width, height: height))
+        let sx = Double(source.width) / Double(width)
+        let sy = Double(source.height) / Double(height)
+        let pixels = source.baseAddress().assumingMemoryBound(to: UInt8.self)
+        for y in 0..<height {
+            let out = (destination.baseAddress() + y * destination.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+            for x in 0..<width {
+                var sums = [0.0, 0.0, 0.0, 0.0]
+                var area = 0.0
+                var j = Int(Double(y) * sy)
+                while Double(j) < Double(y + 1) * sy && j < source.height {
+                    let wy = min(Double(y + 1) * sy, Double(j + 1)) - max(Double(y) * sy, Double(j))
+                    var i = Int(Double(x) * sx)
+                    while Double(i) < Double(x + 1) * sx && i < source.width {
+                        let wx = min(Double(x + 1) * sx, Double(i + 1)) - max(Double(x) * sx, Double(i))
+                        for c in 0..<4 {
+                            sums[c] += wx * wy * Double(pixels[j * source.bytesPerRow() + i * 4 + c])
+                        }
+                        area += wx * wy
+                        i += 1
+                    }
+                    j += 1
+                }
+                for c in 0..<4 {
+                    out[x * 4 + c] = UInt8((sums[c] / area).rounded())
+                }
+            }
+        }
+        return destination
+    }
+
+    // MARK: - Correctness
+
+    func testFlatColourSurvivesEveryMode() throws {
+        let source = try XCTUnwrap(pool.lease(width: 1170, height: 2532))
+        fill(source, with: 0x7B)
+        for mode in [Downscaler.Mode.box, .bilinear, .areaAverage] {
+            let destination = try XCTUnwrap(pool.lease(width: 592, height: 1280))
+            Downscaler(mode: mode).scale(source, into: destination)
+            let reference = try XCTUnwrap(pool.lease(width: 592, height: 1280))
+            fill(reference, with: 0x7B)
+            XCTAssertEqual(Downscaler.psnr(destination, reference), .infinity, "\(mode)")
+            pool.recycle(destination)
+            pool.recycle(reference)
+        }
+    }
+
+    func testHalvingFastPathMatchesGenericBox() throws {
+        // 37 output columns leaves a scalar tail after the eight-pixel vector loop.
+        let source = try makeScreen(width: 74, height: 50)
+        let fast = try XCTUnwrap(pool.lease(width: 37, height: 25))
+        let generic = try XCTUnwrap(pool.lease(width: 37, height: 25))
+        Downscaler(mode: .box).scale(source, into: fast)
+        Downscaler(mode: .box, allowsFastPaths: false).scale(source, into: generic)
+        XCTAssertEqual(Downscaler.psnr(fast, generic), .infinity)
+    }
+
+    func testHalvingAveragesTwoByTwoBlocks() throws {
+        let source = try XCTUnwrap(pool.lease(width: 16, height: 2))
+        let pixels = source.baseAddress().assumingMemoryBound(to: UInt8.self)
+        for y in 0..<2 {
+            for x in 0..<16 {
+                for c in 0..<4 {
+                    pixels[y * source.bytesPerRow() + x * 4 + c] = UInt8(x * 10 + y * 3 + c)
+                }
+            }
+        }
+        let destination = try XCTUnwrap(pool.lease(width: 8, height: 1))
+        Downscaler.halve(source, into: destination)
+        let out = destination.baseAddress().assumingMemoryBound(to: UInt8.self)
+        for x in 0..<8 {
+            for c in 0..<4 {
+                // (20x + 10x + 10 + 3 + 3 + 4c) / 4, rounded.
+                let expected = (Int(x * 20 + c) + Int(x * 20 + 10 + c) + Int(x * 20 + 3 + c) + Int(x * 20 + 13 + c) + 2) / 4
+                XCTAssertEqual(Int(out[x * 4 + c]), expected)
+            }
+        }
+    }
+
+    // MARK: - Quality
+
+    func testQualityAgainstReference() throws {
+        let source = try makeScreen(width: 1170, height: 2532)
+        let reference = try referenceAreaAverage(source, width: 592, height: 1280)
+        var results: [String: Double] = [:]
+        for (name, mode) in [("box", Downscaler.Mode.box), ("bilinear", .bilinear), ("area", .areaAverage)] {
+            let destination = try XCTUnwrap(pool.lease(width: 592, height: 1280))
+            Downscaler(mode: mode).scale(source, into: destination)
+            results[name] = Downscaler.psnr(destination, reference)
+            pool.recycle(destination)
+        }
+        XCTAssertGreaterThan(results["area"] ?? 0, 45, "PSNR vs area reference (dB): \(results)")
+        // Equal-weight blocks misplace the 3-pixel stripes by up to a source pixel, which
+        // costs box about 18.5 dB here; cropping instead of scaling scores under 10.
+        XCTAssertGreaterThan(results["box"] ?? 0, 17, "PSNR vs area reference (dB): \(results)")
+        XCTAssertGreaterThan(results["bilinear"] ?? 0, 20, "PSNR vs area reference (dB): \(results)")
+    }
+
+    /// On smooth content an equal-weight box is close to exact, so anything short of
+    /// reading every source pixel, such as a crop, shows up as a large error.
+    func testBoxCoversTheWholeSource() throws {
+        let source = try XCTUnwrap(pool.lease(width: 1170, height: 2532))
+        for y in 0..<source.height {
+            let row = (source.baseAddress() + y * source.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+            for x in 0..<source.width {
+                row[x * 4] = UInt8(x * 255 / (source.width - 1))
+                row[x * 4 + 1] = UInt8(y * 255 / (source.height - 1))
+                row[x * 4 + 2] = UInt8((x + y) * 255 / (source.width + source.height - 2))
+                row[x * 4 + 3] = 0xFF
+            }
+        }
+        let reference = try referenceAreaAverage(source, width: 592, height: 1280)
+        let destination = try XCTUnwrap(pool.lease(width: 592, height: 1280))
+        Downscaler(mode: .box).scale(source, into: destination)
+        let psnr = Downscaler.psnr(destination, reference)
+        XCTAssertGreaterThan(psnr, 35, "box PSNR vs area reference: \(psnr) dB")
+    }
+
+    // MARK: - Benchmarks
+
+    private func measureScaling(mode: Downscaler.Mode, from size: (Int, Int), to output: (Int, Int)) throws {
+        let source = try makeScreen(width: size.0, height: size.1)
+        let destination = try XCTUnwrap(pool.lease(width: output.0, height: output.1))
+        let downscaler = Downscaler(mode: mode)
+        downscaler.scale(source, into: destination)
+        measure {
+            for _ in 0..<5 {
+                downscaler.scale(source, into: destination)
+            }
+        }
+    }
+
+    /// The ratio `ScreenCapturer`'s snapshot mode produces on 2x and 3x screens.
+    func testPerformanceExactHalving() throws {
+        try measureScaling(mode: .areaAverage, from: (1184, 2560), to: (592, 1280))
+    }
+
+    /// Native 3x iPhone raster straight to output size.
+    func testPerformanceAreaAverage() throws {
+        try measureScaling(mode: .areaAverage, from: (1170, 2532), to: (592, 1280))
+    }
+
+    func testPerformanceBilinear() throws {
+        try measureScaling(mode: .bilinear, from: (1170, 2532), to: (592, 1280))
+    }
+
+    func testPerformanceBox() throws {
+        try measureScaling(mode: .box, from: (1170, 2532), to: (592, 1280))
+    }
+}
@@ -0,0 +1,214 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class DrawSignalTests: XCTestCase {
+
+    private let payload = Data("{\"stroke\":\"#00ff00\",\"strokeWidth\":3,\"path\":[[\"M\",1,2],[\"Q\",3,4,5,6],[\"L\",7,8]]}".utf8)
+        .base64EncodedString()
+
+    private func chunks(of payload: String, count: Int, eventId: String = "stroke") -> [DrawEndSignal] {
+        let length = (payload.count + count - 1) / count
+        let characters = Array(payload)
+        return (0..<count).map { order in
+            let start = min(order * length, characters.count)
+            let end = min(start + length, characters.count)
+            return DrawEndSignal(action: "draw", eventId: eventId, order: order, totalChunks: count,
+                                 value: String(characters[start..<end]))
+        }
+    }
+
+    func testDecodesFabricPath() throws {
+        let path = try XCTUnwrap(FabricPathObject.decode(fromBase64: payload))
+        XCTAssertEqual(path.stroke, "#00ff00")
+        XCTAssertEqual(path.strokeWidth, 3)
+        XCTAssertEqual(extractPoints(from: path.path), [CGPoint(x: 1, y: 2), CGPoint(x: 3, y: 4), CGPoint(x: 7, y: 8)])
+        XCTAssertNil(FabricPathObject.decode(fromBase64: "not base64"))
+    }
+
+    func testReassemblesOutOfOrderChunks() {
+        let assembler = DrawChunkAssembler()
+        let signals = chunks(of: payload, count: 4)
+        XCTAssertNil(assembler.insert(signals[2]))
+        XCTAssertNil(assembler.insert(signals[0]))
+        XCTAssertNil(assembler.insert(signals[3]))
+        XCTAssertEqual(assembler.pendingEventCount, 1)
+        XCTAssertEqual(assembler.insert(signals[1]), payload)
+        XCTAssertEqual(assembler.pendingEventCount, 0)
+    }
+
+    func testKeepsEventsApart() {
+        let assembler = DrawChunkAssembler()
+        let first = chunks(of: payload, count: 2, eventId: "a")
+        let second = chunks(of: payload, count: 2, eventId: "b")
+        XCTAssertNil(assembler.insert(first[0]))
+        XCTAssertNil(assembler.insert(second[1]))
+        XCTAssertEqual(assembler.insert(second[0]), payload)
+        XCTAssertEqual(assembler.insert(first[1]), payload)
+    }
+
+    func testIgnoresDuplicateChunks() {
+        let assembler = DrawChunkAssembler()
+        let signals = chunks(of: payload, count: 3)
+        XCTAssertNil(assembler.insert(signals[0]))
+        XCTAssertNil(assembler.insert(signals[0]))
+        XCTAssertNil(assembler.insert(signals[1]))
+        XCTAssertNil(assembler.insert(signals[1]))
+        XCTAssertEqual(assembler.insert(signals[2]), payload)
+        XCTAssertEqual(assembler.counters.duplicates, 2)
+        XCTAssertEqual(assembler.pendingBytes, 0)
+    }
+
+    func testRejectsInvalidChunks() {
+        let assembler = DrawChunkAssembler(configuration: .init(maximumChunksPerEvent: 16))
+        let signals = chunks(of: payload, count: 2)
+        let invalid = [
+            DrawEndSignal(action: "draw", eventId: "x", order: 2, totalChunks: 2, value: "a"),
+            DrawEndSignal(action: "draw", eventId: "x", order: -1, totalChunks: 2, value: "a"),
+            DrawEndSignal(action: "draw", eventId: "x", order: 0, totalChunks: 0, value: "a"),
+            DrawEndSignal(action: "draw", eventId: "x", order: 0, totalChunks: 17, value: "a"),
+            DrawEndSignal(action: "draw", eventId: "stroke", order: 1, totalChunks: 3, value: "a")
+        ]
+        XCTAssertNil(assembler.insert(signals[0]))
+        for signal in invalid {
+            XCTAssertNil(assembler.insert(signal))
+        }
+        XCTAssertEqual(assembler.counters.rejected, invalid.count)
+        XCTAssertEqual(assembler.insert(signals[1]), payload)
+    }
+
+    func testExpiresIncompleteEvents() {
+        let clock = ManualClock()
+        let assembler = DrawChunkAssembler(configuration: .init(timeToLive: 1), clock: clock)
+        let lost = chunks(of: payload, count: 2, eventId: "lost")
+        let late = chunks(of: payload, count: 2, eventId: "late")
+        XCTAssertNil(assembler.insert(lost[0]))
+        clock.advance(milliseconds: 600)
+        XCTAssertNil(assembler.insert(late[0]))
+        clock.advance(milliseconds: 600)
+        assembler.evictExpired()
+        XCTAssertEqual(assembler.pendingEventCount, 1)
+        XCTAssertEqual(assembler.counters.expired, 1)
+        XCTAssertEqual(assembler.insert(late[1]), payload)
+
+        // The rest of an expired event starts over instead of completing it.
+        XCTAssertNil(assembler.insert(lost[1]))
+        XCTAssertEqual(assembler.pendingEventCount, 1)
+        XCTAssertEqual(assembler.pendingBytes, lost[1].value.utf8.count + DrawChunkAssembler.slotBytes(totalChunks: 2))
+    }
+
+    func testDropsLateCopiesOfCompletedEvents() {
+        let clock = ManualClock()
+        let assembler = DrawChunkAssembler(configuration: .init(timeToLive: 1), clock: clock)
+        let single = chunks(of: payload, count: 1, eventId: "single")
+        let signals = chunks(of: payload, count: 3)
+        XCTAssertEqual(assembler.insert(single[0]), payload)
+        XCTAssertNil(assembler.insert(single[0]))
+        XCTAssertNil(assembler.append(signals[1]))
+        XCTAssertEqual(assembler.append(signals[0])?.isComplete, false)
+        XCTAssertEqual(assembler.append(signals[2])?.isComplete, true)
+        for signal in signals {
+            XCTAssertNil(assembler.append(signal))
+        }
+        XCTAssertEqual(assembler.counters.duplicates, 4)
+        XCTAssertEqual(assembler.counters.completed, 2)
+        XCTAssertEqual(assembler.pendingEventCount, 0)
+        XCTAssertEqual(assembler.pendingBytes, 0)
+
+        // Forgotten once `timeToLive` has passed.
+        clock.advance(milliseconds: 1_000)
+        XCTAssertEqual(assembler.insert(single[0]), payload)
+    }
+
+    func testEvictsOldestEventsOverTheMemoryCap() {
+        let chunkBytes = chunks(of: payload, count: 4)[0].value.utf8.count
+        let slotBytes = DrawChunkAssembler.slotBytes(totalChunks: 4)
+        let cap = chunkBytes * 5 + slotBytes * 3
+        let assembler = DrawChunkAssembler(configuration: .init(maximumPendingBytes: cap))
+        let events = (0..<3).map { chunks(of: payload, count: 4, eventId: "event-\($0)") }
+        for event in events {
+            XCTAssertNil(assembler.insert(event[0]))
+            XCTAssertNil(assembler.insert(event[1]))
+        }
+        XCTAssertEqual(assembler.counters.evicted, 1)
+        XCTAssertEqual(assembler.pendingEventCount, 2)
+        XCTAssertLessThanOrEqual(assembler.pendingBytes, cap)
+        for event in events.dropFirst() {
+            XCTAssertNil(assembler.insert(event[2]))
+            XCTAssertEqual(assembler.insert(event[3]), payload)
+        }
+        XCTAssertEqual(assembler.pendingBytes, 0)
+    }
+
+    func testChargesSlotsAgainstTheMemoryCap() {
+        let slotBytes = DrawChunkAssembler.slotBytes(totalChunks: 4096)
+        let assembler = DrawChunkAssembler(configuration: .init(maximumPendingBytes: slotBytes + 1024))
+        for event in 0..<3 {
+            XCTAssertNil(assembler.insert(DrawEndSignal(action: "draw", eventId: "wide-\(event)", order: 0,
+                                                        totalChunks: 4096, value: "a")))
+        }
+        XCTAssertEqual(assembler.pendingEventCount, 1)
+        XCTAssertEqual(assembler.counters.evicted, 2)
+        XCTAssertEqual(assembler.pendingBytes, slotBytes + 1)
+    }
+
+    func testStreamsTheContiguousPrefix() throws {
+        let clock = ManualClock(nanoseconds: 1_000)
+        let assembler = DrawChunkAssembler(clock: clock)
+        let signals = chunks(of: payload, count: 4)
+        XCTAssertNil(assembler.append(signals[1]))
+        clock.advance(milliseconds: 5)
+        var points: [CGPoint] = []
+        var update = try XCTUnwrap(assembler.append(signals[0]))
+        XCTAssertEqual(update.firstChunkTime, 1_000)
+        XCTAssertFalse(update.isComplete)
+        points += extractPoints(from: update.commands)
+        XCTAssertNil(assembler.append(signals[1]))
+        XCTAssertEqual(assembler.counters.duplicates, 1)
+        XCTAssertNil(assembler.append(signals[3]))
+        update = try XCTUnwrap(assembler.append(signals[2]))
+        XCTAssertTrue(update.isComplete)
+        XCTAssertEqual(update.stroke, "#00ff00")
+        XCTAssertEqual(update.strokeWidth, 3)
+        points += extractPoints(from: update.commands)
+        XCTAssertEqual(points, [CGPoint(x: 1, y: 2), CGPoint(x: 3, y: 4), CGPoint(x: 7, y: 8)])
+        XCTAssertEqual(assembler.pendingEventCount, 0)
+        XCTAssertEqual(assembler.pendingBytes, 0)
+        XCTAssertEqual(assembler.counters.completed, 1)
+    }
+
+    func testStreamingReleasesDeliveredChunks() {
+        let assembler = DrawChunkAssembler()
+        let signals = chunks(of: payload, count: 4)
+        _ = assembler.append(signals[0])
+        _ = assembler.append(signals[1])
+        let slotBytes = DrawChunkAssembler.slotBytes(totalChunks: 4)
+        XCTAssertEqual(assembler.pendingBytes, slotBytes)
+        _ = assembler.append(signals[3])
+        XCTAssertEqual(assembler.pendingBytes, slotBytes + signals[3].value.utf8.count)
+        XCTAssertTrue(assembler.isPending("stroke"))
+    }
+
+    // MARK: - Benchmarks
+
+    /// 1,000 strokes of eight chunks, interleaved, with every chunk sent twice.
+    func testPerformanceReassembly() {
+        var signals: [DrawEndSignal] = []
+        let strokes = (0..<1_000).map { chunks(of: payload, count: 8, eventId: "stroke-\($0)") }
+        for order in [3, 0, 7, 1, 5, 2, 6, 4] {
+            for stroke in strokes {
+                signals.append(stroke[order])
+                signals.append(stroke[order])
+            }
+        }
+        measure {
+            let assembler = DrawChunkAssembler()
+            var completed = 0
+            for signal in signals where assembler.insert(signal) != nil {
+                completed += 1
+            }
+            XCTAssertEqual(completed, strokes.count)
+            XCTAssertEqual(assembler.counters.duplicates, signals.count / 2)
+            XCTAssertEqual(assembler.pendingEventCount, 0)
+        }
+    }
+}
@@ -0,0 +1,114 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class DrawStreamDecoderTests: XCTestCase {
+
+    private func base64(_ json: String) -> String {
+        return Data(json.utf8).base64EncodedString()
+    }
+
+    /// A Fabric path object with `points` quadratic segments, like the agent console sends.
+    private func fabricPayload(points: Int) -> String {
+        var path: [String] = ["[\"M\",100.5,200.25]"]
+        for index in 1..<points {
+            let x = 100.5 + Double(index) * 1.75
+            let y = 200.25 + sin(Double(index) / 12) * 80
+            path.append("[\"Q\",\(x - 0.875),\(y + 0.5),\(x),\(y)]")
+        }
+        return base64("{\"stroke\":\"#ff7a00\",\"strokeWidth\":5,\"path\":[\(path.joined(separator: ","))]}")
+    }
+
+    private func pieces(of text: String, length: Int) -> [String] {
+        let characters = Array(text)
+        return stride(from: 0, to: characters.count, by: length).map {
+            String(characters[$0..<min($0 + length, characters.count)])
+        }
+    }
+
+    private func decodeAll(_ payload: String, pieceLength: Int) -> (DrawStreamDecoder, [[PathCommandValue]]) {
+        let decoder = DrawStreamDecoder()
+        var commands: [[PathCommandValue]] = []
+        for piece in pieces(of: payload, length: pieceLength) {
+            commands += decoder.feed(piece)
+        }
+        return (decoder, commands)
+    }
+
+    func testMatchesWholePayloadDecodeForAnySplit() throws {
+        let payload = fabricPayload(points: 40)
+        let expected = try XCTUnwrap(FabricPathObject.decode(fromBase64: payload))
+        for pieceLength in [1, 3, 4, 7, 64, payload.count] {
+            let (decoder, commands) = decodeAll(payload, pieceLength: pieceLength)
+            XCTAssertFalse(decoder.hasFailed, "\(pieceLength)")
+            XCTAssertTrue(decoder.isFinished, "\(pieceLength)")
+            XCTAssertEqual(decoder.stroke, expected.stroke)
+            XCTAssertEqual(decoder.strokeWidth, expected.strokeWidth)
+            XCTAssertEqual(extractPoints(from: commands), extractPoints(from: expected.path), "\(pieceLength)")
+        }
+    }
+
+    func testCommandsArriveAsSoonAsTheyAreComplete() {
+        let json = "{\"stroke\":\"#123456\",\"path\":[[\"M\",1,2],[\"L\",3,4],[\"L\",5,6]]}"
+        let decoder = DrawStreamDecoder()
+        let payload = base64(json)
+        // Everything up to the end of the second command, rounded down to whole quads.
+        let end = json.range(of: "4]")!.upperBound.utf16Offset(in: json)
+        let prefixLength = (end + 2) / 3 * 4
+        let first = decoder.feed(String(payload.prefix(prefixLength)))
+        XCTAssertEqual(extractPoints(from: first), [CGPoint(x: 1, y: 2), CGPoint(x: 3, y: 4)])
+        XCTAssertEqual(decoder.stroke, "#123456")
+        XCTAssertFalse(decoder.isFinished)
+        let rest = decoder.feed(String(payload.dropFirst(prefixLength)))
+        XCTAssertEqual(extractPoints(from: rest), [CGPoint(x: 5, y: 6)])
+        XCTAssertTrue(decoder.isFinished)
+    }
+
+    func testSkipsOtherMembers() {
+        let json = """
+        {"type":"path","path":[["M",1,2],["Q",3,4,5,6]],"shadow":{"color":"rgba(0,0,0,0.2)","blur":[1,2]},
+         "label":"a \\"quoted\\" [brace} , text","strokeWidth": 4.5 ,"stroke":"#00ff00","strokeDashArray":null}
+        """
+        for padding in ["", " ", "  "] {
+            let (decoder, commands) = decodeAll(base64(json + padding), pieceLength: 5)
+            XCTAssertFalse(decoder.hasFailed)
+            XCTAssertEqual(decoder.stroke, "#00ff00")
+            XCTAssertEqual(decoder.strokeWidth, 4.5)
+            XCTAssertEqual(decoder.commandCount, 2)
+            XCTAssertEqual(extractPoints(from: commands), [CGPoint(x: 1, y: 2), CGPoint(x: 3, y: 4)])
+        }
+    }
+
+    func testFailsOnMalformedInput() {
+        XCTAssertTrue(decodeAll("not base64!", pieceLength: 4).0.hasFailed)
+        XCTAssertTrue(decodeAll(base64("[1,2]"), pieceLength: 4).0.hasFailed)
+        XCTAssertTrue(decodeAll(base64("{\"path\":[[\"M\",x,2]]}"), pieceLength: 4).0.hasFailed)
+        let decoder = DrawStreamDecoder()
+        _ = decoder.feed("e30=")
+        XCTAssertTrue(decoder.isFinished)
+        XCTAssertTrue(decoder.feed("AAAA").isEmpty)
+    }
+
+    // MARK: - Benchmarks
+
+    /// A 500-point stroke in eight chunks, for comparison with decoding the joined payload.
+    func testPerformanceStreamDecode() {
+        let payload = fabricPayload(points: 500)
+        let chunks = pieces(of: payload, length: (payload.count + 7) / 8)
+        measure {
+            let decoder = DrawStreamDecoder()
+            var count = 0
+            for chunk in chunks {
+                count += decoder.feed(chunk).count
+            }
+            XCTAssertEqual(count, 500)
+        }
+    }
+
+    func testPerformanceWholeDecodeBaseline() {
+        let payload = fabricPayload(points: 500)
+        measure {
+            XCTAssertEqual(FabricPathObject.decode(fromBase64: payload)?.path.count, 500)
+        }
+    }
+}
+
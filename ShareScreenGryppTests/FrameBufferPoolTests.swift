@@ -0,0 +1,134 @@
+import XCTest
+@testable import ShareScreenGrypp
+#if canImport(AllocationCounter)
+import AllocationCounter
+#endif
+
+final class FrameBufferPoolTests: XCTestCase {
+
+    func testBuffersAreStrideAligned() throws {
+        let pool = FrameBufferPool()
+        let buffer = try XCTUnwrap(pool.lease(width: 591, height: 1280))
+        XCTAssertEqual(buffer.bytesPerRow(), 2368)
+        XCTAssertEqual(buffer.bytesPerRow() % FrameBufferPool.alignment, 0)
+        XCTAssertEqual(Int(bitPattern: buffer.baseAddress()) % FrameBufferPool.alignment, 0)
+        XCTAssertGreaterThanOrEqual(buffer.byteCount, buffer.bytesPerRow() * 1280)
+    }
+
+    func testRingIsExhaustedUntilBuffersAreRecycled() throws {
+        let pool = FrameBufferPool(capacity: 2)
+        let first = try XCTUnwrap(pool.lease(width: 64, height: 64))
+        let second = try XCTUnwrap(pool.lease(width: 64, height: 64))
+        XCTAssertFalse(first === second)
+        XCTAssertNil(pool.lease(width: 64, height: 64))
+        XCTAssertEqual(pool.counters.exhaustions, 1)
+
+        pool.recycle(first)
+        let third = try XCTUnwrap(pool.lease(width: 64, height: 64))
+        XCTAssertTrue(third === first)
+        XCTAssertEqual(pool.counters.allocations, 2)
+    }
+
+    func testRingsAreKeyedByDimensionsAndEvictedWhenIdle() throws {
+        let pool = FrameBufferPool(capacity: 2, maximumRetainedKeys: 2)
+        let portrait = try XCTUnwrap(pool.lease(width: 592, height: 1280))
+        let landscape = try XCTUnwrap(pool.lease(width: 1280, height: 592))
+        XCTAssertEqual(portrait.key, FrameBufferKey(width: 592, height: 1280, format: .bgra))
+        XCTAssertEqual(landscape.key, FrameBufferKey(width: 1280, height: 592, format: .bgra))
+        XCTAssertEqual(pool.counters.allocations, 4)
+
+        // A third key evicts the ring with nothing leased.
+        pool.recycle(landscape)
+        _ = try XCTUnwrap(pool.lease(width: 640, height: 640))
+        XCTAssertEqual(pool.counters.allocations, 6)
+
+        // Going back to landscape reallocates; with both remaining rings busy the key limit
+        // is exceeded rather than freeing memory that is still in use.
+        _ = try XCTUnwrap(pool.lease(width: 1280, height: 592))
+        XCTAssertEqual(pool.counters.allocations, 8)
+        pool.recycle(portrait)
+    }
+
+    /// Mimics steady-state capture, including a pipeline that holds a frame while the next
+    /// one is captured: after warm-up the pool must not create buffers again.
+    func testSteadyStateLeasingCreatesNoBuffers() throws {
+        let pool = FrameBufferPool(capacity: 3)
+        var inFlight: [FrameBuffer] = []
+        inFlight.reserveCapacity(2)
+        for _ in 0..<2 {
+            inFlight.append(try XCTUnwrap(pool.lease(width: 592, height: 1280)))
+        }
+        let warmAllocations = pool.counters.allocations
+
+        for _ in 0..<10_000 {
+            let buffer = try XCTUnwrap(pool.lease(width: 592, height: 1280))
+            buffer.baseAddress().storeBytes(of: 0xFF, as: UInt8.self)
+            pool.recycle(inFlight.removeFirst())
+            inFlight.append(buffer)
+        }
+
+        let counters = pool.counters
+        XCTAssertEqual(counters.allocations, warmAllocations)
+        XCTAssertEqual(counters.exhaustions, 0)
+        XCTAssertEqual(counters.leases, 10_002)
+        XCTAssertEqual(counters.recycles, 10_000)
+    }
+
+    /// The portable stages of one captured frame, from lease to recycle: downscale, redact,
+    /// dirty-check and convert. Once warm they must not touch the heap at all.
+    func testSteadyStatePipelineMakesNoHeapAllocations() throws {
+        #if canImport(AllocationCounter)
+        guard allocation_counter_is_supported() != 0 else {
+            throw XCTSkip("allocation counting needs glibc")
+        }
+        let pool = FrameBufferPool(capacity: 1, maximumRetainedKeys: 3)
+        let downscaler = Downscaler(mode: .areaAverage)
+        let redactor = PixelRedactor()
+        let hasher = FrameTileHasher()
+        let regions = [RedactionRegion(rect: PixelRect(x: 40, y: 200, width: 512, height: 56), action: .fill),
+                       RedactionRegion(rect: PixelRect(x: 40, y: 300, width: 512, height: 56), action: .mosaic),
+                       RedactionRegion(rect: PixelRect(x: 40, y: 400, width: 512, height: 56), action: .blur)]
+        var frame: UInt8 = 0
+        func capture() -> Bool {
+            guard let raster = pool.lease(width: 1290, height: 2796),
+                  let output = pool.lease(width: 592, height: 1280),
+                  let yuv = pool.lease(width: 592, height: 1280, format: .nv12) else { return false }
+            frame &+= 1
+            raster.baseAddress().storeBytes(of: frame, as: UInt8.self)
+            downscaler.scale(raster, into: output)
+            redactor.apply(regions, in: output, color: .translucentBlack)
+            let report = hasher.update(baseAddress: output.baseAddress(), width: output.width,
+                                       height: output.height, bytesPerRow: output.bytesPerRow())
+            PixelConverter.convert(output, into: yuv)
+            pool.recycle(yuv)
+            pool.recycle(output)
+            pool.recycle(raster)
+            return report.totalTiles > 0
+        }
+
+        XCTAssertTrue(capture())
+        XCTAssertTrue(capture())
+        var captured = true
+        allocation_counter_start()
+        for _ in 0..<5 {
+            captured = capture() && captured
+        }
+        let allocations = allocation_counter_stop()
+        XCTAssertTrue(captured)
+        XCTAssertEqual(allocations, 0)
+        #else
+        throw XCTSkip("allocation counting is only built by the Swift package")
+        #endif
+    }
+
+    func testPerformanceLeaseRecycle() {
+        let pool = FrameBufferPool()
+        measure {
+            for _ in 0..<100_000 {
+                if let buffer = pool.lease(width: 592, height: 1280) {
+                    pool.recycle(buffer)
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,115 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class FrameClockTests: XCTestCase {
+
+    private let interval: UInt64 = 66_666_666
+
+    func testFirstFrameStartsAtZero() {
+        let clock = ManualClock(nanoseconds: 5_000_000_000)
+        let frameClock = FrameClock(clock: clock)
+        let stamp = frameClock.stamp(nominalInterval: interval)
+        XCTAssertEqual(stamp.captureTime, 5_000_000_000)
+        XCTAssertEqual(stamp.presentationTime, 0)
+    }
+
+    func testJitteredCapturesArePacedToTheNominalGrid() {
+        let clock = ManualClock()
+        let frameClock = FrameClock(clock: clock)
+        _ = frameClock.stamp(nominalInterval: interval)
+        let wobble: [Int64] = [4_000_000, -3_000_000, 7_000_000, -6_000_000, 1_000_000, 0, -2_000_000]
+        for (index, offset) in wobble.enumerated() {
+            clock.advance(by: UInt64(Int64(interval) + offset))
+            let stamp = frameClock.stamp(nominalInterval: interval)
+            XCTAssertEqual(stamp.presentationTime, UInt64(index + 1) * interval)
+        }
+        let jitter = frameClock.statistics.jitter
+        XCTAssertEqual(jitter.count, UInt64(wobble.count))
+        XCTAssertEqual(Double(jitter.maximum), 7_000_000, accuracy: 1)
+        XCTAssertEqual(jitter.minimum, 0)
+    }
+
+    func testSkippedTicksKeepRealTime() {
+        let clock = ManualClock()
+        let frameClock = FrameClock(clock: clock)
+        _ = frameClock.stamp(nominalInterval: interval)
+        // An unchanged screen is not re-sent for three ticks.
+        clock.advance(by: 3 * interval + 2_000_000)
+        XCTAssertEqual(frameClock.stamp(nominalInterval: interval).presentationTime, 3 * interval)
+        XCTAssertEqual(frameClock.statistics.frameIntervals.maximum, 3 * interval + 2_000_000)
+    }
+
+    func testPresentationNeverDriftsFromRealTime() {
+        let clock = ManualClock()
+        let frameClock = FrameClock(clock: clock)
+        _ = frameClock.stamp(nominalInterval: interval)
+        var seed: UInt32 = 42
+        var elapsed: UInt64 = 0
+        var previous: UInt64 = 0
+        for _ in 0..<10_000 {
+            seed = seed &* 1_664_525 &+ 1_013_904_223
+            // Real intervals consistently 9% long with +/- 10 ms noise.
+            let step = interval + interval / 11 + UInt64(seed) % 20_000_000 - 10_000_000
+            clock.advance(by: step)
+            elapsed += step
+            let presentation = frameClock.stamp(nominalInterval: interval).presentationTime
+            XCTAssertGreaterThan(presentation, previous)
+            XCTAssertLessThanOrEqual(presentation > elapsed ? presentation - elapsed : elapsed - presentation, interval / 2 + 1)
+            previous = presentation
+        }
+    }
+
+    func testEarlyCaptureStillAdvances() {
+        let clock = ManualClock()
+        let frameClock = FrameClock(clock: clock)
+        _ = frameClock.stamp(nominalInterval: interval)
+        // A touch brings the next capture forward by most of an interval.
+        clock.advance(milliseconds: 10)
+        let stamp = frameClock.stamp(nominalInterval: interval)
+        XCTAssertEqual(stamp.presentationTime, 10_000_000)
+        clock.advance(by: 100)
+        XCTAssertEqual(frameClock.stamp(nominalInterval: interval).presentationTime, 10_000_000 + FrameClock.minimumStep)
+    }
+
+    func testResumeBeforeFirstFrameStartsAtZero() {
+        let clock = ManualClock()
+        let frameClock = FrameClock(clock: clock)
+        frameClock.resume()
+        clock.advance(by: interval)
+        XCTAssertEqual(frameClock.stamp(nominalInterval: interval).presentationTime, 0)
+    }
+
+    /// A background/foreground cycle stops and starts capture on the same stream.
+    func testStopAndStartKeepsPresentationTimeGoingForward() {
+        let clock = ManualClock()
+        let frameClock = FrameClock(clock: clock)
+        _ = frameClock.stamp(nominalInterval: interval)
+        clock.advance(by: interval)
+        let beforePause = frameClock.stamp(nominalInterval: interval).presentationTime
+        XCTAssertEqual(beforePause, interval)
+
+        frameClock.resume()
+        clock.advance(by: 3_000_000_123)
+        let afterPause = frameClock.stamp(nominalInterval: interval).presentationTime
+        XCTAssertEqual(afterPause, beforePause + 3_000_000_123)
+        XCTAssertEqual(frameClock.statistics.frameIntervals.count, 0)
+
+        // Pacing picks up again from the resumed frame.
+        clock.advance(by: interval + 2_000_000)
+        XCTAssertEqual(frameClock.stamp(nominalInterval: interval).presentationTime, afterPause + interval)
+        XCTAssertEqual(frameClock.statistics.frameIntervals.count, 1)
+
+        // A resume right after a frame presents the next one at its real time.
+        frameClock.resume()
+        clock.advance(by: 100)
+        XCTAssertEqual(frameClock.stamp(nominalInterval: interval).presentationTime,
+                       afterPause + interval + 2_000_100)
+    }
+
+    func testPresentationTicks() {
+        let stamp = FrameClock.Stamp(captureTime: 0, presentationTime: 12_345_678_901)
+        XCTAssertEqual(stamp.presentationTicks(timescale: 1_000_000), 12_345_678)
+        XCTAssertEqual(stamp.presentationTicks(timescale: 90_000), 1_111_111)
+        XCTAssertEqual(stamp.presentationTicks(timescale: 1000), 12_345)
+    }
+}
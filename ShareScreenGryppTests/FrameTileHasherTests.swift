@@ -0,0 +1,113 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class FrameTileHasherTests: XCTestCase {
+
+    // Portrait output of `ScreenCapturer` for a 3x iPhone (1280 tall, odd tile remainder).
+    private let width = 592
+    private let height = 1280
+    private var bytesPerRow: Int { width * 4 }
+
+    private func makeFrame(bandOffset: Int = 0) -> [UInt8] {
+        var pixels = [UInt8](repeating: 0xFF, count: bytesPerRow * height)
+        // Mostly white with grey "form field" bands, like a static app screen.
+        for y in 0..<height where (y + bandOffset) % 96 < 40 {
+            for x in 16..<(width - 16) {
+                let i = y * bytesPerRow + x * 4
+                pixels[i] = 0xE0
+                pixels[i + 1] = 0xE0
+                pixels[i + 2] = 0xE0
+            }
+        }
+        return pixels
+    }
+
+    private func update(_ hasher: FrameTileHasher, _ pixels: [UInt8], width: Int? = nil, height: Int? = nil) -> FrameTileHasher.Report {
+        let w = width ?? self.width
+        let h = height ?? self.height
+        return pixels.withUnsafeBytes {
+            hasher.update(baseAddress: $0.baseAddress!, width: w, height: h, bytesPerRow: w * 4)
+        }
+    }
+
+    private func setPixel(_ pixels: inout [UInt8], x: Int, y: Int) {
+        pixels[y * bytesPerRow + x * 4] ^= 0x01
+    }
+
+    // MARK: - Correctness
+
+    func testFirstFrameIsFullyDirty() {
+        let hasher = FrameTileHasher(tileSize: 32)
+        let report = update(hasher, makeFrame())
+        XCTAssertEqual(report.totalTiles, 19 * 40)
+        XCTAssertEqual(report.changedTiles, report.totalTiles)
+    }
+
+    func testStaticFrameReportsNoChanges() {
+        let hasher = FrameTileHasher()
+        let frame = makeFrame()
+        _ = update(hasher, frame)
+        let report = update(hasher, frame)
+        XCTAssertFalse(report.isDirty)
+        XCTAssertEqual(report.changedTiles, 0)
+    }
+
+    func testSinglePixelChangeDirtiesOneTile() {
+        let hasher = FrameTileHasher()
+        var frame = makeFrame()
+        _ = update(hasher, frame)
+        setPixel(&frame, x: 100, y: 700)
+        XCTAssertEqual(update(hasher, frame).changedTiles, 1)
+        XCTAssertEqual(update(hasher, frame).changedTiles, 0)
+    }
+
+    func testChangesOnTileBoundariesHitBothTiles() {
+        let hasher = FrameTileHasher(tileSize: 32)
+        var frame = makeFrame()
+        _ = update(hasher, frame)
+        setPixel(&frame, x: 31, y: 31)
+        setPixel(&frame, x: 32, y: 32)
+        XCTAssertEqual(update(hasher, frame).changedTiles, 2)
+    }
+
+    func testPartialEdgeTilesAreTracked() {
+        let hasher = FrameTileHasher(tileSize: 32)
+        var frame = makeFrame()
+        _ = update(hasher, frame)
+        setPixel(&frame, x: width - 1, y: height - 1)
+        XCTAssertEqual(update(hasher, frame).changedTiles, 1)
+    }
+
+    func testResizeAndResetReportFullFrame() {
+        let hasher = FrameTileHasher(tileSize: 64)
+        let frame = makeFrame()
+        _ = update(hasher, frame)
+        let resized = update(hasher, frame, width: 512, height: 1024)
+        XCTAssertEqual(resized.changedTiles, 8 * 16)
+        hasher.reset()
+        XCTAssertEqual(update(hasher, frame, width: 512, height: 1024).changedTiles, 8 * 16)
+    }
+
+    // MARK: - Benchmarks
+
+    func testPerformanceStaticFrame() {
+        let hasher = FrameTileHasher()
+        let frame = makeFrame()
+        _ = update(hasher, frame)
+        measure {
+            for _ in 0..<30 {
+                _ = update(hasher, frame)
+            }
+        }
+    }
+
+    func testPerformanceScrollingFrames() {
+        let hasher = FrameTileHasher()
+        let frames = [makeFrame(), makeFrame(bandOffset: 12)]
+        measure {
+            for i in 0..<30 {
+                _ = update(hasher, frames[i % 2])
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class LatencyHistogramTests: XCTestCase {
+
+    func testBucketsAreContiguousAndTight() {
+        var previousUpper: UInt64?
+        for index in 0..<(LatencyHistogram.bucketCount - 1) {
+            let lower = LatencyHistogram.lowerBound(ofBucket: index)
+            let upper = LatencyHistogram.upperBound(ofBucket: index)
+            if let previousUpper = previousUpper {
+                XCTAssertEqual(lower, previousUpper + 1, "bucket \(index)")
+            }
+            XCTAssertEqual(LatencyHistogram.bucketIndex(of: lower), index)
+            XCTAssertEqual(LatencyHistogram.bucketIndex(of: upper), index)
+            if lower >= 32 {
+                XCTAssertLessThanOrEqual(Double(upper - lower) / Double(lower), 1.0 / 16)
+            }
+            previousUpper = upper
+        }
+        XCTAssertEqual(LatencyHistogram.bucketIndex(of: .max), LatencyHistogram.bucketCount - 1)
+    }
+
+    func testPercentiles() {
+        var histogram = LatencyHistogram()
+        XCTAssertEqual(histogram.value(atPercentile: 50), 0)
+        for millisecond in 1...100 {
+            histogram.record(UInt64(millisecond) * 1_000_000)
+        }
+        XCTAssertEqual(histogram.count, 100)
+        XCTAssertEqual(histogram.minimum, 1_000_000)
+        XCTAssertEqual(histogram.maximum, 100_000_000)
+        XCTAssertEqual(histogram.mean, 50_500_000, accuracy: 1)
+        XCTAssertEqual(Double(histogram.value(atPercentile: 50)), 50_000_000, accuracy: 50_000_000 / 16)
+        XCTAssertEqual(Double(histogram.value(atPercentile: 99)), 99_000_000, accuracy: 99_000_000 / 16)
+        XCTAssertEqual(histogram.value(atPercentile: 100), 100_000_000)
+        XCTAssertEqual(histogram.value(atPercentile: 0), 1_000_000)
+    }
+
+    func testMergeAndReset() {
+        var a = LatencyHistogram()
+        var b = LatencyHistogram()
+        a.record(10)
+        b.record(1_000)
+        b.record(5)
+        a.merge(b)
+        XCTAssertEqual(a.count, 3)
+        XCTAssertEqual(a.minimum, 5)
+        XCTAssertEqual(a.maximum, 1_000)
+        a.reset()
+        XCTAssertEqual(a.count, 0)
+        XCTAssertEqual(a.value(atPercentile: 99), 0)
+    }
+
+    // MARK: - Benchmarks
+
+    func testDetachedCopyMatchesTheOriginal() {
+        var histogram = LatencyHistogram()
+        for microsecond in 1...50 {
+            histogram.record(UInt64(microsecond) * 1_000)
+        }
+        let reference = histogram
+        let copy = histogram.detachedCopy()
+        histogram.record(9_000_000)
+        XCTAssertEqual(copy.count, 50)
+        XCTAssertEqual(copy.minimum, 1_000)
+        XCTAssertEqual(copy.maximum, 50_000)
+        XCTAssertEqual(copy.mean, 25_500, accuracy: 0.5)
+        for percentile in [1.0, 50, 90, 99] {
+            XCTAssertEqual(copy.value(atPercentile: percentile), reference.value(atPercentile: percentile))
+        }
+        XCTAssertEqual(LatencyHistogram().detachedCopy().count, 0)
+    }
+
+    func testPerformanceRecord() {
+        var histogram = LatencyHistogram()
+        measure {
+            var value: UInt64 = 1
+            for _ in 0..<1_000_000 {
+                value = value &* 6_364_136_223_846_793_005 &+ 1
+                histogram.record(value >> 34)
+            }
+        }
+        XCTAssertGreaterThan(histogram.count, 0)
+    }
+}
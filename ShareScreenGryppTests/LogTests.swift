@@ -0,0 +1,136 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class LogTests: XCTestCase {
+
+    private let log = Logger(category: "test")
+    private let lock = NSLock()
+    private var received: [LogRecord] = []
+
+    override func setUp() {
+        super.setUp()
+        LogCenter.shared.flush()
+        LogCenter.shared.minimumLevel = .trace
+        LogCenter.shared.sink = { [unowned self] record in
+            self.lock.lock()
+            self.received.append(record)
+            self.lock.unlock()
+        }
+    }
+
+    override func tearDown() {
+        LogCenter.shared.flush()
+        LogCenter.shared.sink = { print($0.formatted) }
+        LogCenter.shared.minimumLevel = .trace
+        super.tearDown()
+    }
+
+    private func messages() -> [String] {
+        LogCenter.shared.flush()
+        lock.lock()
+        defer { lock.unlock() }
+        return received.map { $0.message }
+    }
+
+    func testDeliversInOrder() {
+        for index in 0..<10 {
+            log.info("message \(index)")
+        }
+        log.error("failed")
+        XCTAssertEqual(messages(), (0..<10).map { "message \($0)" } + ["failed"])
+        XCTAssertEqual(received.last?.level, .error)
+        XCTAssertTrue(received[0].formatted.hasSuffix("info test: message 0"))
+    }
+
+    func testDisabledLevelsDontBuildTheirMessage() {
+        var built = 0
+        func message() -> String {
+            built += 1
+            return "built"
+        }
+        LogCenter.shared.minimumLevel = .warning
+        log.info(message())
+        log.debug(message())
+        XCTAssertEqual(built, 0)
+        log.warning(message())
+        XCTAssertEqual(built, 1)
+        if Logger.compiledLevel > .trace {
+            LogCenter.shared.minimumLevel = .trace
+            log.trace(message())
+            XCTAssertEqual(built, 1)
+        }
+        XCTAssertEqual(messages(), ["built"])
+    }
+
+    func testKeepsEachThreadsOrder() {
+        let threads = 8
+        let perThread = 50
+        DispatchQueue.concurrentPerform(iterations: threads) { thread in
+            for index in 0..<perThread {
+                self.log.info("\(thread) \(index)")
+            }
+        }
+        var next = [Int](repeating: 0, count: threads)
+        var dropped = 0
+        for message in messages() {
+            let parts = message.split(separator: " ")
+            if parts.last == "dropped" {
+                dropped += Int(parts[0]) ?? 0
+                continue
+            }
+            let thread = Int(parts[0])!, index = Int(parts[1])!
+            XCTAssertGreaterThanOrEqual(index, next[thread])
+            next[thread] = index + 1
+        }
+        XCTAssertEqual(next, [Int](repeating: perThread, count: threads))
+        XCTAssertEqual(dropped, 0)
+    }
+
+    func testFullRingDropsOldestAndReportsIt() {
+        let capacity = LogCenter.shared.ringCapacity
+        // Keep the drain busy so this thread's ring fills up.
+        let release = DispatchSemaphore(value: 0)
+        LogCenter.shared.sink = { [unowned self] record in
+            release.wait()
+            release.signal()
+            self.lock.lock()
+            self.received.append(record)
+            self.lock.unlock()
+        }
+        log.info("first")
+        for index in 0..<(capacity + 10) {
+            log.info("\(index)")
+        }
+        release.signal()
+        let all = messages()
+        XCTAssertTrue(all.contains("\(capacity + 9)"))
+        XCTAssertTrue(all.contains { $0.hasSuffix("records dropped") })
+        XCTAssertLessThan(all.count, capacity + 12)
+    }
+
+    // MARK: - Benchmarks
+
+    /// A million disabled calls with an interpolated message: compiled out for `trace`,
+    /// one comparison for levels filtered at run time.
+    func testPerformanceDisabledLevels() {
+        LogCenter.shared.minimumLevel = .error
+        let point = CGPoint(x: 12.5, y: 99)
+        measure {
+            for index in 0..<1_000_000 {
+                log.trace("Touch point: \(point) \(index)")
+                log.info("Touch point: \(point) \(index)")
+            }
+        }
+        XCTAssertEqual(messages(), [])
+    }
+
+    func testPerformanceEnabledLevel() {
+        LogCenter.shared.sink = { _ in }
+        measure {
+            for index in 0..<10_000 {
+                log.info("Touch point \(index)")
+            }
+            LogCenter.shared.flush()
+        }
+    }
+}
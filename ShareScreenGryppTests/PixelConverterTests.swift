@@ -0,0 +1,143 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class PixelConverterTests: XCTestCase {
+
+    private let pool = FrameBufferPool(capacity: 2, maximumRetainedKeys: 8)
+
+    /// Deterministic gradient plus noise so every channel and coefficient is exercised.
+    private func makeSource(width: Int, height: Int) throws -> FrameBuffer {
+        let buffer = try XCTUnwrap(pool.lease(width: width, height: height, format: .bgra))
+        var seed: UInt32 = 0x1234_5678
+        for y in 0..<height {
+            let row = buffer.baseAddress().advanced(by: y * buffer.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+            for x in 0..<width {
+                seed = seed &* 1_664_525 &+ 1_013_904_223
+                row[x * 4] = UInt8(truncatingIfNeeded: x * 7 + Int(seed >> 28))
+                row[x * 4 + 1] = UInt8(truncatingIfNeeded: y * 5 + Int(seed >> 24))
+                row[x * 4 + 2] = UInt8(truncatingIfNeeded: (x + y) * 3)
+                row[x * 4 + 3] = 0xFF
+            }
+        }
+        return buffer
+    }
+
+    private func plane(_ buffer: FrameBuffer, _ index: Int) -> [[UInt8]] {
+        let plane = buffer.planes[index]
+        let rowBytes = buffer.format == .nv12 && index == 1 ? plane.width * 2 : plane.width
+        return (0..<plane.height).map { y in
+            let row = UnsafeRawBufferPointer(start: buffer.baseAddress(ofPlane: index) + y * plane.bytesPerRow, count: rowBytes)
+            return Array(row)
+        }
+    }
+
+    private func convert(_ source: FrameBuffer, format: FramePixelFormat, matrix: YCbCrMatrix,
+                         implementation: PixelConverter.Implementation) throws -> FrameBuffer {
+        let destination = try XCTUnwrap(pool.lease(width: source.width, height: source.height, format: format))
+        PixelConverter.convert(source, into: destination, matrix: matrix, implementation: implementation)
+        return destination
+    }
+
+    // MARK: - Accuracy
+
+    func testVectorizedMatchesScalarReference() throws {
+        // 37x21 leaves a vector tail and odd edges; 1280x720 is the common landscape case.
+        for (width, height) in [(37, 21), (1280, 720)] {
+            let source = try makeSource(width: width, height: height)
+            for format in [FramePixelFormat.nv12, .i420] {
+                for matrix in [YCbCrMatrix.bt601, .bt709] {
+                    let scalar = try convert(source, format: format, matrix: matrix, implementation: .scalar)
+                    let vectorized = try convert(source, format: format, matrix: matrix, implementation: .vectorized)
+                    for index in scalar.planes.indices {
+                        XCTAssertEqual(plane(scalar, index), plane(vectorized, index), "\(width)x\(height) \(format) plane \(index)")
+                    }
+                    pool.recycle(scalar)
+                    pool.recycle(vectorized)
+                }
+            }
+            pool.recycle(source)
+        }
+    }
+
+    func testFixedPointMatchesFloatingPointBT601() throws {
+        let width = 64, height = 32
+        let source = try makeSource(width: width, height: height)
+        let nv12 = try convert(source, format: .nv12, matrix: .bt601, implementation: .vectorized)
+        let luma = plane(nv12, 0)
+        let chroma = plane(nv12, 1)
+        let pixels = source.baseAddress().assumingMemoryBound(to: UInt8.self)
+
+        func rgb(_ x: Int, _ y: Int) -> (Double, Double, Double) {
+            let i = y * source.bytesPerRow() + x * 4
+            return (Double(pixels[i + 2]), Double(pixels[i + 1]), Double(pixels[i]))
+        }
+
+        for y in 0..<height {
+            for x in 0..<width {
+                let (r, g, b) = rgb(x, y)
+                let expected = 16 + (65.481 * r + 128.553 * g + 24.966 * b) / 255
+                XCTAssertEqual(Double(luma[y][x]), expected, accuracy: 1.5)
+            }
+        }
+        for cy in 0..<height / 2 {
+            for cx in 0..<width / 2 {
+                var (r, g, b) = (0.0, 0.0, 0.0)
+                for (dx, dy) in [(0, 0), (1, 0), (0, 1), (1, 1)] {
+                    let p = rgb(cx * 2 + dx, cy * 2 + dy)
+                    r += p.0 / 4
+                    g += p.1 / 4
+                    b += p.2 / 4
+                }
+                let cb = 128 + (-37.797 * r - 74.203 * g + 112.0 * b) / 255
+                let cr = 128 + (112.0 * r - 93.786 * g - 18.214 * b) / 255
+                XCTAssertEqual(Double(chroma[cy][cx * 2]), cb, accuracy: 1.5)
+                XCTAssertEqual(Double(chroma[cy][cx * 2 + 1]), cr, accuracy: 1.5)
+            }
+        }
+    }
+
+    func testVideoRangeExtremes() throws {
+        for (value, expectedLuma) in [(UInt8(0), UInt8(16)), (UInt8(255), UInt8(235))] {
+            let source = try XCTUnwrap(pool.lease(width: 32, height: 2, format: .bgra))
+            for y in 0..<2 {
+                (source.baseAddress() + y * source.bytesPerRow()).initializeMemory(as: UInt8.self, repeating: value, count: 32 * 4)
+            }
+            for matrix in [YCbCrMatrix.bt601, .bt709] {
+                let i420 = try convert(source, format: .i420, matrix: matrix, implementation: .vectorized)
+                XCTAssertEqual(Set(plane(i420, 0).joined()), [expectedLuma])
+                XCTAssertEqual(Set(plane(i420, 1).joined()), [128])
+                XCTAssertEqual(Set(plane(i420, 2).joined()), [128])
+                pool.recycle(i420)
+            }
+            pool.recycle(source)
+        }
+    }
+
+    // MARK: - Benchmarks
+
+    private func measureConversion(width: Int, height: Int, implementation: PixelConverter.Implementation) throws {
+        let source = try makeSource(width: width, height: height)
+        let destination = try XCTUnwrap(pool.lease(width: width, height: height, format: .nv12))
+        measure {
+            for _ in 0..<10 {
+                PixelConverter.convert(source, into: destination, implementation: implementation)
+            }
+        }
+    }
+
+    func testPerformance720pVectorized() throws {
+        try measureConversion(width: 1280, height: 720, implementation: .vectorized)
+    }
+
+    func testPerformance720pScalar() throws {
+        try measureConversion(width: 1280, height: 720, implementation: .scalar)
+    }
+
+    func testPerformance1280pPortraitVectorized() throws {
+        try measureConversion(width: 592, height: 1280, implementation: .vectorized)
+    }
+
+    func testPerformance1280pPortraitScalar() throws {
+        try measureConversion(width: 592, height: 1280, implementation: .scalar)
+    }
+}
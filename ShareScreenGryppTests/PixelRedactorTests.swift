@@ -0,0 +1,281 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class PixelRedactorTests: XCTestCase {
+
+    private let pool = FrameBufferPool(capacity: 3, maximumRetainedKeys: 4)
+
+    private func makeFrame(width: Int = 592, height: Int = 1280) throws -> FrameBuffer {
+        let buffer = try XCTUnwrap(pool.lease(width: width, height: height))
+        for y in 0..<height {
+            let row = (buffer.baseAddress() + y * buffer.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+            for x in 0..<width {
+                row[x * 4] = UInt8(truncatingIfNeeded: x)
+                row[x * 4 + 1] = UInt8(truncatingIfNeeded: y)
+                row[x * 4 + 2] = UInt8(truncatingIfNeeded: x ^ y)
+                row[x * 4 + 3] = 0xFF
+            }
+        }
+        return buffer
+    }
+
+    private func pixel(_ buffer: FrameBuffer, _ x: Int, _ y: Int) -> [UInt8] {
+        let row = (buffer.baseAddress() + y * buffer.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+        return Array(UnsafeBufferPointer(start: row + x * 4, count: 4))
+    }
+
+    /// Floating-point source-over of a premultiplied colour.
+    private func expectedBlend(_ pixel: [UInt8], _ color: RedactionColor) -> [UInt8] {
+        let overlay = [color.blue, color.green, color.red, color.alpha]
+        let keep = 1 - Double(color.alpha) / 255
+        return (0..<4).map { UInt8((Double(overlay[$0]) + Double(pixel[$0]) * keep).rounded()) }
+    }
+
+    // MARK: - Correctness
+
+    func testBlendMatchesFloatingPointEverywhere() throws {
+        let color = RedactionColor(red: 0.2, green: 0.4, blue: 0.9, alpha: 0.7)
+        // 37 pixels wide leaves a scalar tail after two vector iterations.
+        let frame = try makeFrame(width: 40, height: 4)
+        let original = try makeFrame(width: 40, height: 4)
+        PixelRedactor().fill([PixelRect(x: 2, y: 1, width: 37, height: 2)], in: frame, color: color)
+        for y in 0..<4 {
+            for x in 0..<40 {
+                let inside = (2..<39).contains(x) && (1..<3).contains(y)
+                let expected = inside ? expectedBlend(pixel(original, x, y), color) : pixel(original, x, y)
+                let actual = pixel(frame, x, y)
+                for c in 0..<4 {
+                    XCTAssertEqual(Double(actual[c]), Double(expected[c]), accuracy: 1, "(\(x), \(y)) channel \(c)")
+                }
+            }
+        }
+    }
+
+    func testOverlappingRectsBlendOnce() throws {
+        let color = RedactionColor.translucentBlack
+        let frame = try makeFrame()
+        let reference = try makeFrame()
+        let redactor = PixelRedactor(bandHeight: 16)
+        redactor.fill([PixelRect(x: 10, y: 10, width: 100, height: 100),
+                       PixelRect(x: 50, y: 50, width: 100, height: 100),
+                       PixelRect(x: 10, y: 10, width: 100, height: 100)], in: frame, color: color)
+        redactor.fill([PixelRect(x: 10, y: 10, width: 100, height: 100)], in: reference, color: color)
+        redactor.fill([PixelRect(x: 50, y: 110, width: 100, height: 40),
+                       PixelRect(x: 110, y: 50, width: 40, height: 60)], in: reference, color: color)
+        for y in 0..<200 {
+            for x in 0..<200 {
+                XCTAssertEqual(pixel(frame, x, y), pixel(reference, x, y), "(\(x), \(y))")
+            }
+        }
+    }
+
+    func testRectsAreClippedToTheFrame() throws {
+        let frame = try makeFrame(width: 64, height: 64)
+        let opaque = RedactionColor(red: 1, green: 0, blue: 0, alpha: 1)
+        PixelRedactor().fill([PixelRect(x: -20, y: 60, width: 30, height: 50),
+                              PixelRect(x: 100, y: 0, width: 10, height: 10)], in: frame, color: opaque)
+        for y in 0..<64 {
+            for x in 0..<64 {
+                let covered = x < 10 && y >= 60
+                XCTAssertEqual(pixel(frame, x, y) == [0, 0, 255, 255], covered, "(\(x), \(y))")
+            }
+        }
+    }
+
+    func testApplyRunsFillsAfterBlurAndMosaic() throws {
+        let frame = try makeFrame(width: 64, height: 64)
+        let expected = try makeFrame(width: 64, height: 64)
+        let rect = PixelRect(x: 8, y: 8, width: 40, height: 40)
+        let redactor = PixelRedactor(mosaicBlockSize: 8)
+        redactor.apply([RedactionRegion(rect: rect, action: .fill),
+                        RedactionRegion(rect: rect, action: .mosaic)], in: frame, color: .translucentBlack)
+        redactor.pixelate(rect, in: expected)
+        redactor.fill([rect], in: expected, color: .translucentBlack)
+        for y in 0..<64 {
+            for x in 0..<64 {
+                XCTAssertEqual(pixel(frame, x, y), pixel(expected, x, y), "(\(x), \(y))")
+            }
+        }
+    }
+
+    /// Block averages computed pixel by pixel, the way the mosaic kernel started out.
+    private func referencePixelate(_ rect: PixelRect, in buffer: FrameBuffer, block: Int) {
+        let target = rect.clipped(width: buffer.width, height: buffer.height)
+        guard !target.isEmpty else { return }
+        var top = target.y
+        while top < target.maxY {
+            let bottom = min((top / block + 1) * block, target.maxY)
+            var left = target.x
+            while left < target.maxX {
+                let right = min((left / block + 1) * block, target.maxX)
+                var sum = [0, 0, 0, 0]
+                for y in top..<bottom {
+                    for x in left..<right {
+                        let value = pixel(buffer, x, y)
+                        for c in 0..<4 { sum[c] += Int(value[c]) }
+                    }
+                }
+                let count = (bottom - top) * (right - left)
+                for y in top..<bottom {
+                    let row = (buffer.baseAddress() + y * buffer.bytesPerRow()).assumingMemoryBound(to: UInt8.self)
+                    for x in left..<right {
+                        for c in 0..<4 { row[x * 4 + c] = UInt8((sum[c] + count / 2) / count) }
+                    }
+                }
+                left = right
+            }
+            top = bottom
+        }
+    }
+
+    func testMosaicMatchesReference() throws {
+        // Odd offsets and widths leave partial blocks and a scalar tail on every side.
+        let cases = [(PixelRect(x: 3, y: 5, width: 117, height: 50), 12),
+                     (PixelRect(x: 0, y: 0, width: 64, height: 64), 16),
+                     (PixelRect(x: 7, y: 1, width: 9, height: 3), 1),
+                     (PixelRect(x: 30, y: 20, width: 98, height: 90), 256),
+                     (PixelRect(x: -10, y: 100, width: 50, height: 80), 8)]
+        for (rect, block) in cases {
+            let frame = try makeFrame(width: 128, height: 128)
+            let reference = try makeFrame(width: 128, height: 128)
+            PixelRedactor(mosaicBlockSize: block).pixelate(rect, in: frame)
+            referencePixelate(rect, in: reference, block: block)
+            for y in 0..<128 {
+                for x in 0..<128 {
+                    XCTAssertEqual(pixel(frame, x, y), pixel(reference, x, y), "\(rect) block \(block) at (\(x), \(y))")
+                }
+            }
+            pool.recycle(frame)
+            pool.recycle(reference)
+        }
+    }
+
+    func testMosaicBlocksAreAlignedToTheFrame() throws {
+        let whole = try makeFrame(width: 96, height: 96)
+        let split = try makeFrame(width: 96, height: 96)
+        let redactor = PixelRedactor(mosaicBlockSize: 12)
+        redactor.pixelate(PixelRect(x: 12, y: 24, width: 48, height: 36), in: whole)
+        // Two halves cut on a block boundary produce the same blocks as the whole rect.
+        redactor.pixelate(PixelRect(x: 12, y: 24, width: 24, height: 36), in: split)
+        redactor.pixelate(PixelRect(x: 36, y: 24, width: 24, height: 36), in: split)
+        for y in 0..<96 {
+            for x in 0..<96 {
+                XCTAssertEqual(pixel(whole, x, y), pixel(split, x, y), "(\(x), \(y))")
+            }
+        }
+        XCTAssertEqual(pixel(whole, 12, 24), pixel(whole, 23, 35))
+    }
+
+    func testCoveringRoundsOutward() {
+        let rect = PixelRect(covering: CGRect(x: 1.5, y: 2.25, width: 3, height: 0.5))
+        XCTAssertEqual(rect, PixelRect(x: 1, y: 2, width: 4, height: 1))
+        XCTAssertTrue(PixelRect(x: 5, y: 5, width: 0, height: 3).isEmpty)
+    }
+
+    func testPremultipliedColour() {
+        let color = RedactionColor(red: 1, green: 0.5, blue: 0, alpha: 0.5)
+        XCTAssertEqual(color.red, 128)
+        XCTAssertEqual(color.green, 64)
+        XCTAssertEqual(color.blue, 0)
+        XCTAssertEqual(color.alpha, 128)
+    }
+
+    // MARK: - Benchmarks
+
+    /// The same 400x400 pt area redacted as `count` strips. Cost should stay flat as the
+    /// count grows, since each covered pixel is blended once.
+    private func measureRedaction(rectCount count: Int) throws {
+        let frame = try makeFrame()
+        let redactor = PixelRedactor()
+        let stripHeight = 400 / count
+        let rects = (0..<count).map { PixelRect(x: 96, y: 300 + $0 * stripHeight, width: 400, height: stripHeight) }
+        measure {
+            for _ in 0..<50 {
+                redactor.fill(rects, in: frame, color: .translucentBlack)
+            }
+        }
+    }
+
+    func testPerformance1Rect() throws {
+        try measureRedaction(rectCount: 1)
+    }
+
+    func testPerformance10Rects() throws {
+        try measureRedaction(rectCount: 10)
+    }
+
+    func testPerformance100Rects() throws {
+        try measureRedaction(rectCount: 100)
+    }
+
+    /// 100 copies of one rect, e.g. stacked sensitive views: still one blend per pixel.
+    func testPerformance100OverlappingRects() throws {
+        let frame = try makeFrame()
+        let redactor = PixelRedactor()
+        let rects = [PixelRect](repeating: PixelRect(x: 96, y: 300, width: 400, height: 400), count: 100)
+        measure {
+            for _ in 0..<50 {
+                redactor.fill(rects, in: frame, color: .translucentBlack)
+            }
+        }
+    }
+
+    /// Mosaic, fill and blur over the same 400x400 area; mosaic should track fill.
+    func testPerformanceMosaic() throws {
+        let frame = try makeFrame()
+        let redactor = PixelRedactor()
+        let rect = PixelRect(x: 96, y: 300, width: 400, height: 400)
+        measure {
+            for _ in 0..<50 {
+                redactor.pixelate(rect, in: frame)
+            }
+        }
+    }
+
+    func testPerformanceFillSameArea() throws {
+        let frame = try makeFrame()
+        let redactor = PixelRedactor()
+        let rect = PixelRect(x: 96, y: 300, width: 400, height: 400)
+        measure {
+            for _ in 0..<50 {
+                redactor.fill([rect], in: frame, color: .translucentBlack)
+            }
+        }
+    }
+
+    func testPerformanceBlurSameArea() throws {
+        let frame = try makeFrame()
+        let blur = BoxBlur()
+        let rect = PixelRect(x: 96, y: 300, width: 400, height: 400)
+        measure {
+            for _ in 0..<50 {
+                blur.blur(rect, in: frame)
+            }
+        }
+    }
+
+    func testPerformanceMosaicReferenceBaseline() throws {
+        let frame = try makeFrame()
+        let rect = PixelRect(x: 96, y: 300, width: 400, height: 400)
+        measure {
+            referencePixelate(rect, in: frame, block: 12)
+        }
+    }
+
+    /// What `UIImage.redact` cost per sensitive view: a full-frame copy before each fill.
+    func testPerformanceFullFrameCopyPerRectBaseline() throws {
+        let frame = try makeFrame()
+        let copy = try makeFrame()
+        let rects = (0..<10).map { PixelRect(x: 96, y: 300 + $0 * 40, width: 400, height: 40) }
+        measure {
+            for _ in 0..<5 {
+                for rect in rects {
+                    memcpy(copy.baseAddress(), frame.baseAddress(), frame.byteCount)
+                    for y in rect.y..<rect.maxY {
+                        PixelRedactor.blend(.translucentBlack, into: copy.baseAddress() + y * copy.bytesPerRow(), from: rect.x, to: rect.maxX)
+                    }
+                }
+            }
+        }
+    }
+}
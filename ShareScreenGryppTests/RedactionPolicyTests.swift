@@ -0,0 +1,166 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class RedactionPolicyTests: XCTestCase {
+
+    private class MockView: RedactionInspectable {
+        var identifier: String?
+        var isSecure = false
+        var contentType: String?
+        var children: [MockView] = []
+        static var classNameReads = 0
+
+        init(identifier: String? = nil, isSecure: Bool = false, contentType: String? = nil, children: [MockView] = []) {
+            self.identifier = identifier
+            self.isSecure = isSecure
+            self.contentType = contentType
+            self.children = children
+        }
+
+        var redactionClassNames: [String] {
+            MockView.classNameReads += 1
+            var names: [String] = []
+            var mirror: Mirror? = Mirror(reflecting: self)
+            while let current = mirror {
+                names.append("App.\(current.subjectType)")
+                mirror = current.superclassMirror
+            }
+            return names
+        }
+
+        var redactionIdentifier: String? { identifier }
+        var redactionIsSecureTextEntry: Bool { isSecure }
+        var redactionContentType: String? { contentType }
+    }
+
+    private final class MockCardField: MockView {}
+    private final class MockLabel: MockView {}
+
+    override func setUp() {
+        super.setUp()
+        MockView.classNameReads = 0
+    }
+
+    // MARK: - Criteria
+
+    func testEachCriterion() {
+        let matcher = RedactionMatcher(policy: RedactionPolicy(rules: [
+            RedactionRule(.className("MockCardField"), action: .mosaic),
+            RedactionRule(.identifier("sensitive")),
+            RedactionRule(.identifierPrefix("pii."), action: .blur),
+            RedactionRule(.identifierPattern("^account-[0-9]+$"), action: .blur),
+            RedactionRule(.secureTextEntry),
+            RedactionRule(.contentType("creditCardNumber"), action: .mosaic)
+        ]))
+        XCTAssertEqual(matcher.action(for: MockCardField()), .mosaic)
+        XCTAssertEqual(matcher.action(for: MockView(identifier: "sensitive")), .fill)
+        XCTAssertEqual(matcher.action(for: MockView(identifier: "pii.email")), .blur)
+        XCTAssertEqual(matcher.action(for: MockView(identifier: "account-42")), .blur)
+        XCTAssertEqual(matcher.action(for: MockView(isSecure: true)), .fill)
+        XCTAssertEqual(matcher.action(for: MockView(contentType: "creditCardNumber")), .mosaic)
+
+        XCTAssertNil(matcher.action(for: MockView()))
+        XCTAssertNil(matcher.action(for: MockLabel(identifier: "pii")))
+        XCTAssertNil(matcher.action(for: MockView(identifier: "account-42b")))
+        XCTAssertNil(matcher.action(for: MockView(contentType: "username")))
+    }
+
+    func testClassRulesMatchSuperclassesAndQualifiedNames() {
+        let byBase = RedactionMatcher(policy: RedactionPolicy(rules: [RedactionRule(.className("MockView"))]))
+        XCTAssertEqual(byBase.action(for: MockLabel()), .fill)
+        let qualified = RedactionMatcher(policy: RedactionPolicy(rules: [RedactionRule(.className("App.MockLabel"))]))
+        XCTAssertEqual(qualified.action(for: MockLabel()), .fill)
+        XCTAssertNil(qualified.action(for: MockCardField()))
+    }
+
+    func testEarliestMatchingRuleWins() {
+        let matcher = RedactionMatcher(policy: RedactionPolicy(rules: [
+            RedactionRule(.contentType("password"), action: .blur),
+            RedactionRule(.secureTextEntry, action: .mosaic),
+            RedactionRule(.identifierPrefix("pw"), action: .fill)
+        ]))
+        XCTAssertEqual(matcher.action(for: MockView(identifier: "pw", isSecure: true, contentType: "password")), .blur)
+        XCTAssertEqual(matcher.action(for: MockView(identifier: "pw", isSecure: true)), .mosaic)
+        XCTAssertEqual(matcher.action(for: MockView(identifier: "pw-field")), .fill)
+    }
+
+    func testInvalidPatternIsSkipped() {
+        let matcher = RedactionMatcher(policy: RedactionPolicy(rules: [
+            RedactionRule(.identifierPattern("(unclosed")),
+            RedactionRule(.identifier("ok"), action: .blur)
+        ]))
+        XCTAssertEqual(matcher.action(for: MockView(identifier: "ok")), .blur)
+        XCTAssertNil(matcher.action(for: MockView(identifier: "(unclosed")))
+    }
+
+    func testStandardPolicyKeepsLegacyTag() {
+        let matcher = RedactionMatcher(policy: .standard)
+        XCTAssertEqual(matcher.action(for: MockView(identifier: "sensitive")), .fill)
+        XCTAssertEqual(matcher.action(for: MockView(isSecure: true)), .fill)
+        XCTAssertEqual(matcher.action(for: MockView(contentType: "oneTimeCode")), .fill)
+        XCTAssertNil(matcher.action(for: MockView(identifier: "sensitive-ish")))
+    }
+
+    // MARK: - Scan
+
+    func testScanPrunesMatchedSubtreesAndMemoizesClasses() {
+        let hiddenChild = MockView(identifier: "sensitive")
+        let form = MockView(identifier: "pii.form", children: [hiddenChild, MockView()])
+        let root = MockView(children: [form, MockLabel(), MockCardField(children: [MockView()]), MockLabel()])
+        let matcher = RedactionMatcher(policy: RedactionPolicy(rules: [
+            RedactionRule(.identifierPrefix("pii."), action: .blur),
+            RedactionRule(.identifier("sensitive")),
+            RedactionRule(.className("MockCardField"), action: .mosaic)
+        ]))
+        var matches: [(node: MockView, action: RedactionAction)] = []
+        matcher.collectMatches(in: root, children: { $0.children }, into: &matches)
+        XCTAssertEqual(matches.count, 2)
+        XCTAssertTrue(matches[0].node === form)
+        XCTAssertEqual(matches[0].action, .blur)
+        XCTAssertTrue(matches[1].node is MockCardField)
+        XCTAssertEqual(matches[1].action, .mosaic)
+        // One read per class: MockView, MockLabel and MockCardField.
+        XCTAssertEqual(MockView.classNameReads, 3)
+    }
+
+    // MARK: - Benchmarks
+
+    /// 5,000 nodes, four children each, against 40 rules of every kind.
+    func testPerformanceScan5000Nodes() {
+        var nodes: [MockView] = []
+        for index in 0..<5_000 {
+            let node: MockView
+            switch index % 50 {
+            case 7: node = MockCardField()
+            case 13: node = MockView(isSecure: true)
+            case 21: node = MockView(identifier: "pii.field\(index % 20)")
+            default: node = index % 3 == 0 ? MockLabel(identifier: "cell.\(index % 40)") : MockView()
+            }
+            nodes.append(node)
+            if index > 0 {
+                nodes[(index - 1) / 4].children.append(node)
+            }
+        }
+        var rules: [RedactionRule] = []
+        for index in 0..<10 {
+            rules.append(RedactionRule(.className("Custom\(index)Field")))
+            rules.append(RedactionRule(.identifierPrefix("pii\(index).")))
+            rules.append(RedactionRule(.identifierPattern("^secret-\(index)-[a-z]+$")))
+            rules.append(RedactionRule(.contentType("type\(index)")))
+        }
+        rules.append(RedactionRule(.identifierPrefix("pii."), action: .blur))
+        rules.append(RedactionRule(.className("MockCardField"), action: .mosaic))
+        rules.append(RedactionRule(.secureTextEntry))
+        let matcher = RedactionMatcher(policy: RedactionPolicy(rules: rules))
+        var matches: [(node: MockView, action: RedactionAction)] = []
+        matcher.collectMatches(in: nodes[0], children: { $0.children }, into: &matches)
+        XCTAssertFalse(matches.isEmpty)
+
+        measure {
+            for _ in 0..<20 {
+                matches.removeAll(keepingCapacity: true)
+                matcher.collectMatches(in: nodes[0], children: { $0.children }, into: &matches)
+            }
+        }
+    }
+}
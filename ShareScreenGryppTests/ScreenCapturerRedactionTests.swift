@@ -0,0 +1,57 @@
+import XCTest
+import UIKit
+@testable import ShareScreenGrypp
+
+final class ScreenCapturerRedactionTests: XCTestCase {
+
+    private var clock: ManualClock!
+    private var root: UIView!
+    private var capturer: ScreenCapturer!
+
+    override func setUp() {
+        super.setUp()
+        clock = ManualClock(nanoseconds: 1_000_000_000)
+        root = UIView(frame: CGRect(x: 0, y: 0, width: 320, height: 640))
+        let view = root!
+        capturer = ScreenCapturer(captureViewProvider: { view }, clock: clock)
+    }
+
+    func testSecureFieldInAScannedHierarchyIsRedactedWithinTheInterval() throws {
+        let field = UITextField(frame: CGRect(x: 20, y: 100, width: 200, height: 40))
+        root.addSubview(field)
+        XCTAssertTrue(capturer.sensitiveRegions(in: root).isEmpty)
+
+        // Nothing observable changes when an on-screen field turns secure.
+        field.isSecureTextEntry = true
+        let interval = try XCTUnwrap(capturer.sensitiveRevalidationInterval)
+        clock.advance(by: UInt64(interval * 1_000_000_000))
+
+        let regions = capturer.sensitiveRegions(in: root)
+        XCTAssertEqual(regions.map { $0.rect }, [field.frame])
+        XCTAssertEqual(regions.first?.action, .fill)
+    }
+
+    func testStaticHierarchyIsRescannedOnlyPerInterval() {
+        root.addSubview(UIView(frame: CGRect(x: 0, y: 0, width: 100, height: 100)))
+        _ = capturer.sensitiveRegions(in: root)
+        XCTAssertEqual(capturer.policyScanCount, 1)
+
+        for _ in 0..<10 {
+            clock.advance(milliseconds: 33)
+            _ = capturer.sensitiveRegions(in: root)
+        }
+        XCTAssertEqual(capturer.policyScanCount, 1)
+
+        clock.advance(milliseconds: 500)
+        _ = capturer.sensitiveRegions(in: root)
+        XCTAssertEqual(capturer.policyScanCount, 2)
+    }
+
+    func testNilIntervalTurnsPeriodicRescansOff() {
+        capturer.sensitiveRevalidationInterval = nil
+        _ = capturer.sensitiveRegions(in: root)
+        clock.advance(by: 10_000_000_000)
+        _ = capturer.sensitiveRegions(in: root)
+        XCTAssertEqual(capturer.policyScanCount, 1)
+    }
+}
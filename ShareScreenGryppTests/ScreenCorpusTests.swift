@@ -0,0 +1,153 @@
+import XCTest
+import ScreenCorpus
+
+final class ScreenCorpusTests: XCTestCase {
+
+    // 1x layout: one pixel per point.
+    private let width = 390
+    private let height = 844
+
+    private func generator(_ scenario: CorpusScenario, seed: UInt64 = 1) -> ScreenCorpusGenerator {
+        return ScreenCorpusGenerator(scenario: scenario, width: width, height: height, seed: seed)
+    }
+
+    /// Bounding box of the pixels that differ, or nil if the frames are identical.
+    private func changedBounds(_ lhs: [UInt8], _ rhs: [UInt8]) -> (minX: Int, minY: Int, maxX: Int, maxY: Int)? {
+        var bounds: (minX: Int, minY: Int, maxX: Int, maxY: Int)?
+        for y in 0..<height {
+            for x in 0..<width {
+                let i = (y * width + x) * 4
+                guard lhs[i..<(i + 4)] != rhs[i..<(i + 4)] else { continue }
+                if let b = bounds {
+                    bounds = (min(b.minX, x), min(b.minY, y), max(b.maxX, x), max(b.maxY, y))
+                } else {
+                    bounds = (x, y, x, y)
+                }
+            }
+        }
+        return bounds
+    }
+
+    // MARK: - Determinism
+
+    func testSameSeedIsByteIdentical() {
+        for scenario in CorpusScenario.allCases {
+            XCTAssertEqual(generator(scenario).render(frame: 37), generator(scenario).render(frame: 37), "\(scenario)")
+        }
+        XCTAssertNotEqual(generator(.list, seed: 1).render(frame: 0), generator(.list, seed: 2).render(frame: 0))
+    }
+
+    func testFramesAreMostlyFlatNotNoise() {
+        for scenario in CorpusScenario.allCases {
+            let frame = generator(scenario).render(frame: 40)
+            var sameAsLeft = 0
+            for y in 0..<height {
+                for x in 1..<width {
+                    let i = (y * width + x) * 4
+                    if frame[i..<(i + 4)] == frame[(i - 4)..<i] {
+                        sameAsLeft += 1
+                    }
+                }
+            }
+            XCTAssertGreaterThan(Double(sameAsLeft) / Double(height * (width - 1)), 0.75, "\(scenario)")
+        }
+    }
+
+    // MARK: - Scenarios
+
+    func testFormOnlyTheCaretBlinks() throws {
+        let form = generator(.form)
+        XCTAssertNil(changedBounds(form.render(frame: 0), form.render(frame: 14)))
+        let caret = try XCTUnwrap(changedBounds(form.render(frame: 14), form.render(frame: 15)))
+        XCTAssertLessThanOrEqual(caret.maxX - caret.minX + 1, 2)
+        XCTAssertLessThanOrEqual(caret.maxY - caret.minY + 1, 22)
+        XCTAssertNil(changedBounds(form.render(frame: 0), form.render(frame: 30)))
+    }
+
+    func testListScrollsUnderAFixedBar() throws {
+        let list = generator(.list)
+        let changed = try XCTUnwrap(changedBounds(list.render(frame: 10), list.render(frame: 11)))
+        XCTAssertGreaterThan(changed.minY, 91)
+        XCTAssertGreaterThan(changed.maxY - changed.minY, height / 2)
+    }
+
+    func testSpinnerChangesOnlyInTheMiddle() throws {
+        let spinner = generator(.spinner)
+        let changed = try XCTUnwrap(changedBounds(spinner.render(frame: 0), spinner.render(frame: 2)))
+        XCTAssertGreaterThanOrEqual(changed.minX, width / 2 - 50)
+        XCTAssertLessThanOrEqual(changed.maxX, width / 2 + 50)
+        XCTAssertGreaterThanOrEqual(changed.minY, height / 2 - 50)
+        XCTAssertLessThanOrEqual(changed.maxY, height / 2 + 50)
+    }
+
+    func testTransitionHoldsThenSlides() {
+        let transition = generator(.transition)
+        let frames = (0..<60).map { transition.render(frame: $0) }
+        XCTAssertEqual(frames[0], frames[29])
+        for index in 30..<48 {
+            XCTAssertNotEqual(frames[index], frames[index - 1], "frame \(index)")
+        }
+        XCTAssertEqual(frames[47], frames[48])
+        XCTAssertEqual(frames[48], frames[59])
+        XCTAssertEqual(transition.render(frame: 60), frames[0])
+    }
+
+    func testVideoChangesEveryFrameInsideItsRect() throws {
+        let video = generator(.video)
+        for index in 1..<5 {
+            let changed = try XCTUnwrap(changedBounds(video.render(frame: index - 1), video.render(frame: index)))
+            XCTAssertGreaterThanOrEqual(changed.minX, 16)
+            XCTAssertLessThan(changed.maxX, width - 16)
+            XCTAssertGreaterThanOrEqual(changed.minY, 180)
+            XCTAssertLessThan(changed.maxY, 180 + (width - 32) * 9 / 16)
+        }
+    }
+
+    func testEveryBuiltInResolutionRenders() {
+        for resolution in CorpusResolution.all {
+            let generator = ScreenCorpusGenerator(scenario: .spinner, resolution: resolution)
+            XCTAssertEqual(generator.render(frame: 0).count, resolution.width * resolution.height * 4, resolution.name)
+        }
+    }
+
+    // MARK: - Files
+
+    func testY4MLayout() throws {
+        let path = NSTemporaryDirectory() + "corpus-\(UUID().uuidString).y4m"
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        let writer = try CorpusWriter(path: path, format: .y4m, width: width, height: height)
+        let form = generator(.form)
+        for index in 0..<3 {
+            writer.write(form.render(frame: index))
+        }
+        writer.close()
+
+        let data = try Data(contentsOf: URL(fileURLWithPath: path))
+        let header = "YUV4MPEG2 W390 H844 F30:1 Ip A1:1 C420mpeg2 XCOLORRANGE=LIMITED\n"
+        XCTAssertEqual(String(decoding: data.prefix(header.utf8.count), as: UTF8.self), header)
+        XCTAssertEqual(data.count, header.utf8.count + 3 * ("FRAME\n".utf8.count + width * height * 3 / 2))
+    }
+
+    func testI420OfWhiteAndBlack() {
+        let white = [UInt8](repeating: 0xFF, count: 4 * 4 * 4)
+        XCTAssertEqual(CorpusWriter.i420(fromBGRA: white, width: 4, height: 4),
+                       [UInt8](repeating: 235, count: 16) + [UInt8](repeating: 128, count: 8))
+        let black = [UInt8](repeating: 0, count: 4 * 4 * 4)
+        XCTAssertEqual(CorpusWriter.i420(fromBGRA: black, width: 4, height: 4),
+                       [UInt8](repeating: 16, count: 16) + [UInt8](repeating: 128, count: 8))
+    }
+
+    // MARK: - Benchmarks
+
+    func testPerformanceRenderIPhoneFrame() {
+        let list = ScreenCorpusGenerator(scenario: .list, resolution: .iPhone15ProMax)
+        var pixels = [UInt8](repeating: 0, count: list.width * list.height * 4)
+        var frame = 0
+        measure {
+            pixels.withUnsafeMutableBytes {
+                list.render(frame: frame, into: $0.baseAddress!, bytesPerRow: list.width * 4)
+            }
+            frame += 1
+        }
+    }
+}
@@ -0,0 +1,184 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class SensitiveViewRegistryTests: XCTestCase {
+
+    /// Minimal stand-in for a view: a frame relative to its parent.
+    private final class MockNode {
+        var frame: CGRect
+        weak var parent: MockNode?
+        var children: [MockNode] = []
+        var isOnScreen = true
+
+        init(_ frame: CGRect, parent: MockNode? = nil) {
+            self.frame = frame
+            self.parent = parent
+            parent?.children.append(self)
+        }
+
+        var rectInRoot: CGRect {
+            guard let parent = parent else { return frame }
+            return frame.offsetBy(dx: parent.rectInRoot.minX, dy: parent.rectInRoot.minY)
+        }
+    }
+
+    private var resolveCount = 0
+
+    private func rects(_ registry: SensitiveViewRegistry<MockNode>) -> [CGRect] {
+        return registry.rects { node in
+            self.resolveCount += 1
+            return node.isOnScreen ? node.rectInRoot : nil
+        }.sorted { ($0.minY, $0.minX) < ($1.minY, $1.minX) }
+    }
+
+    // MARK: - Marking
+
+    func testMarkedNodesResolveToRootCoordinates() {
+        let root = MockNode(CGRect(x: 0, y: 0, width: 390, height: 844))
+        let form = MockNode(CGRect(x: 0, y: 100, width: 390, height: 400), parent: root)
+        let card = MockNode(CGRect(x: 20, y: 40, width: 350, height: 44), parent: form)
+        let cvv = MockNode(CGRect(x: 20, y: 100, width: 120, height: 44), parent: form)
+        let registry = SensitiveViewRegistry<MockNode>()
+        registry.mark(card)
+        registry.mark(cvv)
+        registry.mark(card)
+
+        XCTAssertEqual(registry.count, 2)
+        XCTAssertEqual(rects(registry), [CGRect(x: 20, y: 140, width: 350, height: 44),
+                                         CGRect(x: 20, y: 200, width: 120, height: 44)])
+        XCTAssertTrue(registry.contains(cvv))
+        XCTAssertFalse(registry.contains(form))
+
+        registry.unmark(cvv)
+        XCTAssertEqual(rects(registry), [CGRect(x: 20, y: 140, width: 350, height: 44)])
+    }
+
+    func testOffScreenNodesAreSkipped() {
+        let node = MockNode(CGRect(x: 0, y: 0, width: 10, height: 10))
+        let registry = SensitiveViewRegistry<MockNode>()
+        registry.mark(node)
+        node.isOnScreen = false
+        XCTAssertEqual(rects(registry), [])
+        XCTAssertEqual(registry.count, 1)
+    }
+
+    func testNodesAreHeldWeakly() {
+        let registry = SensitiveViewRegistry<MockNode>()
+        let kept = MockNode(CGRect(x: 0, y: 0, width: 10, height: 10))
+        do {
+            let transient = MockNode(CGRect(x: 0, y: 50, width: 10, height: 10))
+            registry.mark(transient)
+        }
+        registry.mark(kept)
+        XCTAssertEqual(registry.count, 1)
+        XCTAssertEqual(rects(registry), [CGRect(x: 0, y: 0, width: 10, height: 10)])
+    }
+
+    // MARK: - Cache
+
+    func testRectsAreCachedUntilInvalidated() {
+        let node = MockNode(CGRect(x: 0, y: 0, width: 10, height: 10))
+        let registry = SensitiveViewRegistry<MockNode>()
+        registry.mark(node)
+        _ = rects(registry)
+        XCTAssertEqual(resolveCount, 1)
+
+        node.frame.origin.y = 30
+        XCTAssertEqual(rects(registry), [CGRect(x: 0, y: 0, width: 10, height: 10)], "served from cache")
+        XCTAssertEqual(resolveCount, 1)
+
+        registry.invalidate()
+        XCTAssertEqual(rects(registry), [CGRect(x: 0, y: 30, width: 10, height: 10)])
+        XCTAssertEqual(resolveCount, 2)
+
+        registry.unmark(MockNode(.zero))
+        _ = rects(registry)
+        XCTAssertEqual(resolveCount, 2, "unmarking an unknown node keeps the cache")
+    }
+
+    /// Policy scans hand over their whole match set; an unchanged set keeps the cache.
+    func testReplacingWithTheSameNodesKeepsTheCache() {
+        let first = MockNode(CGRect(x: 0, y: 0, width: 10, height: 10))
+        let second = MockNode(CGRect(x: 0, y: 20, width: 10, height: 10))
+        let registry = SensitiveViewRegistry<MockNode>()
+        registry.replaceAll(with: [first, second])
+        XCTAssertFalse(registry.isCached)
+        XCTAssertEqual(rects(registry).count, 2)
+        XCTAssertTrue(registry.isCached)
+
+        registry.replaceAll(with: [second, first])
+        XCTAssertTrue(registry.isCached)
+        XCTAssertEqual(registry.generation, 0)
+
+        registry.replaceAll(with: [second])
+        XCTAssertFalse(registry.isCached)
+        XCTAssertFalse(registry.contains(first))
+        XCTAssertEqual(rects(registry), [CGRect(x: 0, y: 20, width: 10, height: 10)])
+    }
+
+    func testScrollShiftsCachedRectsWithoutRecompute() {
+        let root = MockNode(CGRect(x: 0, y: 0, width: 390, height: 844))
+        let list = MockNode(CGRect(x: 0, y: 100, width: 390, height: 600), parent: root)
+        let header = MockNode(CGRect(x: 0, y: 20, width: 390, height: 44), parent: root)
+        let row = MockNode(CGRect(x: 10, y: 300, width: 200, height: 44), parent: list)
+        let registry = SensitiveViewRegistry<MockNode>()
+        registry.mark(header)
+        registry.mark(row)
+        let place: (MockNode) -> SensitiveViewRegistry<MockNode>.Placement? = { node in
+            SensitiveViewRegistry.Placement(rect: node.rectInRoot,
+                                            scrollContainers: node.parent === list ? [ObjectIdentifier(list)] : [])
+        }
+        _ = registry.rects(placing: place)
+        let generation = registry.generation
+
+        registry.scrollOffsetDidChange(of: ObjectIdentifier(list), by: CGPoint(x: 0, y: 120))
+        registry.scrollOffsetDidChange(of: ObjectIdentifier(list), by: CGPoint(x: 0, y: 30))
+        let rects = registry.rects(placing: place).sorted { $0.minY < $1.minY }
+        XCTAssertEqual(rects, [CGRect(x: 0, y: 20, width: 390, height: 44),
+                               CGRect(x: 10, y: 250, width: 200, height: 44)])
+        XCTAssertEqual(registry.counters.recomputes, 1)
+        XCTAssertEqual(registry.counters.hits, 1)
+        XCTAssertEqual(registry.counters.scrollAdjustments, 2)
+        XCTAssertEqual(registry.generation, generation)
+    }
+
+    func testStaticScreenOnlyHitsTheCache() {
+        let node = MockNode(CGRect(x: 0, y: 0, width: 10, height: 10))
+        let registry = SensitiveViewRegistry<MockNode>()
+        registry.mark(node)
+        for _ in 0..<100 {
+            _ = rects(registry)
+        }
+        XCTAssertEqual(registry.counters.recomputes, 1)
+        XCTAssertEqual(registry.counters.hits, 99)
+        XCTAssertEqual(resolveCount, 1)
+
+        // Layout change notifications arrive in bursts; one recompute follows.
+        for _ in 0..<10 {
+            registry.invalidate()
+        }
+        XCTAssertEqual(registry.generation, 1)
+        _ = rects(registry)
+        XCTAssertEqual(registry.counters.recomputes, 2)
+    }
+
+    // MARK: - Benchmarks
+
+    /// 50 marked fields inside a 5,000-node tree: cached lookups cost nothing per frame.
+    func testPerformanceCachedLookup() {
+        let root = MockNode(CGRect(x: 0, y: 0, width: 390, height: 844))
+        var nodes = [root]
+        for index in 1..<5_000 {
+            nodes.append(MockNode(CGRect(x: 1, y: 2, width: 300, height: 44), parent: nodes[(index - 1) / 4]))
+        }
+        let registry = SensitiveViewRegistry<MockNode>()
+        for node in nodes.suffix(50) {
+            registry.mark(node)
+        }
+        measure {
+            for _ in 0..<10_000 {
+                _ = registry.rects { $0.rectInRoot }
+            }
+        }
+    }
+}
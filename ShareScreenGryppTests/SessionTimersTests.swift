@@ -0,0 +1,147 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class SessionTimersTests: XCTestCase {
+
+    private let clock = ManualClock(nanoseconds: 1_000_000_000)
+
+    private func timers() -> SessionTimers<SessionTimer> {
+        return SessionTimers(tickDuration: 0.01, clock: clock, queue: nil)
+    }
+
+    func testFiresOnceAfterTheDelay() {
+        let timers = self.timers()
+        var fired = 0
+        timers.schedule(.localCursor, after: 5) { fired += 1 }
+        clock.advance(milliseconds: 4_990)
+        XCTAssertEqual(timers.fireDueTimers(), 0)
+        clock.advance(milliseconds: 10)
+        XCTAssertEqual(timers.fireDueTimers(), 1)
+        clock.advance(milliseconds: 10_000)
+        XCTAssertEqual(timers.fireDueTimers(), 0)
+        XCTAssertEqual(fired, 1)
+        XCTAssertFalse(timers.isScheduled(.localCursor))
+    }
+
+    func testRestartPushesTheDeadlineBack() {
+        let timers = self.timers()
+        var fired: [Int] = []
+        for ping in 0..<10 {
+            timers.schedule(.agentCursor, after: 5) { fired.append(ping) }
+            clock.advance(milliseconds: 1_000)
+        }
+        XCTAssertEqual(timers.count, 1)
+        XCTAssertEqual(timers.fireDueTimers(), 0)
+        clock.advance(milliseconds: 4_000)
+        timers.fireDueTimers()
+        XCTAssertEqual(fired, [9])
+    }
+
+    func testKeepEarlierLeavesThePendingDeadline() {
+        let timers = self.timers()
+        var fired: [Int] = []
+        timers.schedule(.agentCursor, after: 5, rearm: .keepEarlier) { fired.append(0) }
+        clock.advance(milliseconds: 3_000)
+        timers.schedule(.agentCursor, after: 5, rearm: .keepEarlier) { fired.append(1) }
+        timers.schedule(.agentCursor, after: 1, rearm: .keepEarlier) { fired.append(2) }
+        clock.advance(milliseconds: 1_000)
+        timers.fireDueTimers()
+        XCTAssertEqual(fired, [2])
+        clock.advance(milliseconds: 10_000)
+        timers.fireDueTimers()
+        XCTAssertEqual(fired, [2])
+    }
+
+    func testCancelAndKeysAreIndependent() {
+        let timers = self.timers()
+        var fired: [SessionTimer] = []
+        for key in [SessionTimer.localCursor, .agentCursor, .stroke("a"), .stroke("b")] {
+            timers.schedule(key, after: 1) { fired.append(key) }
+        }
+        XCTAssertTrue(timers.cancel(.stroke("a")))
+        XCTAssertFalse(timers.cancel(.stroke("a")))
+        clock.advance(milliseconds: 1_000)
+        XCTAssertEqual(timers.fireDueTimers(), 3)
+        XCTAssertEqual(Set(fired), [.localCursor, .agentCursor, .stroke("b")])
+    }
+
+    func testActionsCanRescheduleThemselves() {
+        let timers = self.timers()
+        var ticks = 0
+        func heartbeat() {
+            ticks += 1
+            timers.schedule(.agentCursor, after: 0.5, heartbeat)
+        }
+        timers.schedule(.agentCursor, after: 0.5, heartbeat)
+        for _ in 0..<4 {
+            clock.advance(milliseconds: 500)
+            timers.fireDueTimers()
+        }
+        XCTAssertEqual(ticks, 4)
+        XCTAssertTrue(timers.isScheduled(.agentCursor))
+        timers.cancelAll()
+        XCTAssertEqual(timers.count, 0)
+    }
+
+    /// Random schedules, re-arms and cancels against a dictionary of deadlines.
+    func testMatchesAReferenceModel() {
+        let timers = SessionTimers<Int>(tickDuration: 0.01, clock: clock, queue: nil)
+        var generator = SystemRandomNumberGenerator()
+        var deadlines: [Int: UInt64] = [:]
+        var fired: [Int: UInt64] = [:]
+        for _ in 0..<20_000 {
+            let key = Int.random(in: 0..<500, using: &generator)
+            switch Int.random(in: 0..<10, using: &generator) {
+            case 0..<6:
+                let delayMilliseconds = [UInt64.random(in: 0..<100, using: &generator),
+                                         UInt64.random(in: 0..<10_000, using: &generator),
+                                         UInt64.random(in: 0..<3_000_000, using: &generator)][Int.random(in: 0..<3, using: &generator)]
+                deadlines[key] = clock.nanoseconds + delayMilliseconds * 1_000_000
+                timers.schedule(key, after: Double(delayMilliseconds) / 1000) { fired[key] = self.clock.nanoseconds }
+            case 6:
+                XCTAssertEqual(timers.cancel(key), deadlines.removeValue(forKey: key) != nil)
+            default:
+                clock.advance(by: [UInt64(1_000_000), 50_000_000, 5_000_000_000][Int.random(in: 0..<3, using: &generator)])
+                fired.removeAll()
+                timers.fireDueTimers()
+                for (key, time) in fired {
+                    guard let deadline = deadlines.removeValue(forKey: key) else {
+                        XCTFail("\(key) fired without being scheduled")
+                        continue
+                    }
+                    // Allow a nanosecond for the seconds-to-nanoseconds conversion.
+                    XCTAssertGreaterThanOrEqual(time + 1, deadline)
+                }
+                // Anything still pending isn't overdue by a whole tick.
+                for deadline in deadlines.values {
+                    XCTAssertGreaterThan(deadline + 10_000_001, clock.nanoseconds)
+                }
+            }
+        }
+        XCTAssertEqual(timers.count, deadlines.count)
+    }
+
+    // MARK: - Benchmarks
+
+    /// 100,000 keyed timers spread over ten minutes: schedule them all, re-arm half,
+    /// cancel a quarter, then run the clock past every deadline.
+    func testPerformance100kTimers() {
+        let delays = (0..<100_000).map { TimeInterval(($0 &* 7_919) % 600_000) / 1000 }
+        measure {
+            let timers = SessionTimers<Int>(tickDuration: 0.01, clock: clock, queue: nil)
+            var fired = 0
+            for (key, delay) in delays.enumerated() {
+                timers.schedule(key, after: delay) { fired += 1 }
+            }
+            for key in stride(from: 0, to: delays.count, by: 2) {
+                timers.schedule(key, after: delays[key] / 2) { fired += 1 }
+            }
+            for key in stride(from: 1, to: delays.count, by: 4) {
+                timers.cancel(key)
+            }
+            clock.advance(by: 601_000_000_000)
+            timers.fireDueTimers()
+            XCTAssertEqual(fired, 75_000)
+        }
+    }
+}
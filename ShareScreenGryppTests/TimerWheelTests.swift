@@ -0,0 +1,121 @@
+import XCTest
+@testable import ShareScreenGrypp
+
+final class TimerWheelTests: XCTestCase {
+
+    private let clock = ManualClock(nanoseconds: 5_000_000_000)
+
+    private func wheel() -> TimerWheel<Int> {
+        return TimerWheel(tickDuration: 0.01, clock: clock)
+    }
+
+    func testFiresOnTheFirstTickAtOrAfterTheDeadline() {
+        let timers = wheel()
+        timers.schedule(after: 0.02, 1)
+        timers.schedule(after: 0.025, 2)
+        clock.advance(milliseconds: 19)
+        XCTAssertEqual(timers.advance(), [])
+        clock.advance(milliseconds: 1)
+        XCTAssertEqual(timers.advance(), [1])
+        clock.advance(milliseconds: 9)
+        XCTAssertEqual(timers.advance(), [])
+        clock.advance(milliseconds: 1)
+        XCTAssertEqual(timers.advance(), [2])
+        XCTAssertEqual(timers.count, 0)
+    }
+
+    func testCoalescesTimersDueInTheSameTick() {
+        let timers = wheel()
+        for value in 0..<5 {
+            timers.schedule(after: 0.1 + Double(value) * 0.001, value)
+        }
+        clock.advance(milliseconds: 110)
+        XCTAssertEqual(timers.advance().sorted(), [0, 1, 2, 3, 4])
+    }
+
+    func testCancel() {
+        let timers = wheel()
+        let kept = timers.schedule(after: 1, 1)
+        let cancelled = timers.schedule(after: 1, 2)
+        XCTAssertEqual(timers.cancel(cancelled), 2)
+        XCTAssertNil(timers.cancel(cancelled))
+        XCTAssertFalse(timers.isPending(cancelled))
+        XCTAssertTrue(timers.isPending(kept))
+        clock.advance(milliseconds: 1_000)
+        XCTAssertEqual(timers.advance(), [1])
+        XCTAssertFalse(timers.isPending(kept))
+        XCTAssertNil(timers.cancel(kept))
+    }
+
+    func testStaleHandlesDontCancelReusedEntries() {
+        let timers = wheel()
+        let first = timers.schedule(after: 0.01, 1)
+        clock.advance(milliseconds: 10)
+        XCTAssertEqual(timers.advance(), [1])
+        let second = timers.schedule(after: 0.01, 2)
+        XCTAssertNil(timers.cancel(first))
+        XCTAssertTrue(timers.isPending(second))
+    }
+
+    func testCascadesAcrossLevelsWithoutFiringEarly() {
+        let timers = wheel()
+        let start = clock.nanoseconds
+        // 0.5 s to 50 h, in milliseconds: every level of the wheel, and past its reach.
+        let delays: [UInt64] = [500, 640, 650, 7_000, 41_000, 42_000, 600_000, 2_621_000, 2_622_000,
+                                86_400_000, 180_000_000]
+        for (value, delay) in delays.enumerated() {
+            timers.schedule(atNanoseconds: start + delay * 1_000_000, value)
+        }
+        var fired: [Int] = []
+        for (value, delay) in delays.enumerated() {
+            clock.advance(by: start + (delay - 5) * 1_000_000 - clock.nanoseconds)
+            XCTAssertEqual(timers.advance(), [], "\(delay) fired early")
+            clock.advance(milliseconds: 5)
+            fired += timers.advance()
+            XCTAssertEqual(fired.last, value, "\(delay)")
+        }
+        XCTAssertEqual(fired, Array(delays.indices))
+    }
+
+    func testNextWakeTick() {
+        let timers = wheel()
+        XCTAssertNil(timers.nextWakeTick)
+        let start = timers.currentTick
+        timers.schedule(after: 0.3, 1)
+        XCTAssertEqual(timers.nextWakeTick, start + 30)
+        timers.schedule(after: 0.05, 2)
+        XCTAssertEqual(timers.nextWakeTick, start + 5)
+        // A timer on a higher level wakes the wheel when its level next cascades.
+        let far = timers.schedule(after: 60, 3)
+        XCTAssertEqual(timers.nextWakeTick, start + 5)
+        timers.cancel(timers.schedule(after: 0.01, 4))
+        XCTAssertEqual(timers.nextWakeTick, start + 5)
+        clock.advance(milliseconds: 300)
+        XCTAssertEqual(timers.advance(), [2, 1])
+        XCTAssertEqual(timers.nextWakeTick, (start / 4_096 + 1) * 4_096)
+        timers.cancel(far)
+        XCTAssertNil(timers.nextWakeTick)
+    }
+
+    func testTimersScheduledWhileFiringWaitForALaterTick() {
+        let timers = wheel()
+        timers.schedule(after: 0.01, 1)
+        clock.advance(milliseconds: 10)
+        XCTAssertEqual(timers.advance(), [1])
+        timers.schedule(after: 0, 2)
+        XCTAssertEqual(timers.advance(), [])
+        clock.advance(milliseconds: 10)
+        XCTAssertEqual(timers.advance(), [2])
+    }
+
+    func testRemoveAll() {
+        let timers = wheel()
+        let handle = timers.schedule(after: 1, 1)
+        timers.schedule(after: 100, 2)
+        timers.removeAll()
+        XCTAssertEqual(timers.count, 0)
+        XCTAssertFalse(timers.isPending(handle))
+        clock.advance(milliseconds: 200_000)
+        XCTAssertEqual(timers.advance(), [])
+    }
+}